@@ -0,0 +1,69 @@
+#pragma once
+
+//==============================================================================
+/**
+ * Control-rate linear ramp for one parameter.
+ *
+ * A block is split into sub-blocks of `subBlockSize` samples and the value
+ * moves one step per sub-block, reaching the target on the block's last
+ * sub-block. Setting the target it already has is a no-op, so a parameter
+ * nobody touches never starts a ramp and costs nothing but the compare.
+ */
+class ControlRamp
+{
+public:
+    static constexpr int subBlockSize = 32;
+
+    static int getNumSubBlocks(int numSamples) noexcept
+    {
+        return (numSamples + subBlockSize - 1) / subBlockSize;
+    }
+
+    /** Jumps straight to `value`, cancelling any ramp. */
+    void reset(float value) noexcept
+    {
+        current = target = value;
+        step = 0.0f;
+        remaining = 0;
+    }
+
+    /** Starts a ramp from the current value to `newTarget` over the
+        sub-blocks of a `numSamples` block. Returns true if a ramp started. */
+    bool setTarget(float newTarget, int numSamples) noexcept
+    {
+        if (newTarget == target)
+            return false;
+
+        target = newTarget;
+        remaining = getNumSubBlocks(numSamples);
+
+        if (remaining <= 1)
+        {
+            current = target;
+            remaining = 0;
+            return false;
+        }
+
+        step = (target - current) / (float)remaining;
+        return true;
+    }
+
+    /** Moves one sub-block along the ramp and returns the value to use for it. */
+    float advance() noexcept
+    {
+        if (remaining > 0)
+            current = (--remaining == 0) ? target : current + step;
+
+        return current;
+    }
+
+    bool isRamping() const noexcept { return remaining > 0; }
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept { return target; }
+
+private:
+    float current = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int remaining = 0;
+};
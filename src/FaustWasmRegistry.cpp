@@ -0,0 +1,47 @@
+#include "FaustWasmRegistry.h"
+
+#include <cstring>
+#include <new>
+
+// Null-terminated, generated from FaustWasmModuleTable.cpp.in
+extern const FaustWasmModuleInfo* const faustWasmModules[];
+
+//==============================================================================
+int FaustWasmRegistry::getNumModules() noexcept
+{
+    int numModules = 0;
+    while (faustWasmModules[numModules] != nullptr)
+        ++numModules;
+
+    return numModules;
+}
+
+const FaustWasmModuleInfo& FaustWasmRegistry::getModule(int index) noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, getNumModules()));
+    return *faustWasmModules[index];
+}
+
+const FaustWasmModuleInfo* FaustWasmRegistry::findModule(const char* name) noexcept
+{
+    for (int i = 0; faustWasmModules[i] != nullptr; ++i)
+        if (std::strcmp(faustWasmModules[i]->name, name) == 0)
+            return faustWasmModules[i];
+
+    return nullptr;
+}
+
+//==============================================================================
+FaustWasmInstance::FaustWasmInstance(const FaustWasmModuleInfo& moduleToUse)
+    : module(moduleToUse)
+{
+    storage = ::operator new(module.instanceSize, std::align_val_t(module.instanceAlignment));
+    std::memset(storage, 0, module.instanceSize);
+    module.instantiate(storage, &env);
+}
+
+FaustWasmInstance::~FaustWasmInstance()
+{
+    module.free(storage);
+    ::operator delete(storage, std::align_val_t(module.instanceAlignment));
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "wasm-rt.h"
+#include "WasmMath.h"
+#include <cstdint>
+#include <type_traits>
+
+// The scalar types of wasm2c's generated headers, for code that only sees
+// modules through the registry
+typedef uint32_t u32;
+typedef float f32;
+
+//==============================================================================
+/** One control from a Faust UI description, with groups flattened away. */
+struct FaustWasmControl
+{
+    const char* type = "";  // hslider, vslider, nentry, checkbox, button, hbargraph, vbargraph
+    const char* label = "";
+    u32 index = 0;          // byte offset of the control's zone in the DSP state
+    float init = 0.0f;
+    float min = 0.0f;
+    float max = 1.0f;
+    float step = 0.0f;
+};
+
+/**
+ * What a Faust WASM module says about itself in the JSON it leaves at offset
+ * 0 of a freshly instantiated memory.
+ *
+ * fuzzaver_add_faust_wasm_modules() in CMakeLists.txt extracts the JSON from
+ * the .wasm at configure time and writes it out as a constexpr table (from
+ * FaustWasmDescriptor.h.in), so nothing is instantiated or parsed for it at
+ * runtime. The JSON itself still sits at the bottom of linear memory until
+ * the first init writes Faust's tables over it.
+ */
+struct FaustWasmUiDescriptor
+{
+    const char* name = "";
+    int numInputs = 0;
+    int numOutputs = 0;
+    uint32_t dspSize = 0;       // bytes of DSP state at offset 0
+    uint32_t jsonBytes = 0;     // bytes of JSON at offset 0, terminator included
+    const FaustWasmControl* controls = nullptr;   // in UI order
+    int numControls = 0;
+
+    constexpr bool isValid() const noexcept { return jsonBytes > 0 && dspSize > 0; }
+
+    /** Bytes at the bottom of linear memory the module owns, before and
+        after init; host allocations go above them. */
+    constexpr uint32_t getReservedBytes() const noexcept { return juce::jmax(dspSize, jsonBytes); }
+
+    constexpr const FaustWasmControl* begin() const noexcept { return controls; }
+    constexpr const FaustWasmControl* end() const noexcept { return controls + numControls; }
+};
+
+//==============================================================================
+/**
+ * Entry points of one wasm2c-translated Faust module, with the instance
+ * struct type erased.
+ *
+ * Entries are generated by fuzzaver_add_faust_wasm_modules() in
+ * CMakeLists.txt from FaustWasmModule.cpp.in, one per .wasm file, and
+ * collected in a static table; nothing here is written by hand per module.
+ * The function pointers are the wasm2c exports themselves, so calls cost an
+ * indirect call and nothing is interpreted at runtime.
+ */
+struct FaustWasmModuleInfo
+{
+    const char* name;
+    size_t instanceSize;
+    size_t instanceAlignment;
+
+    void (*instantiate)(void* instance, w2c_env* env);
+    void (*free)(void* instance);
+    wasm_rt_memory_t* (*memory)(void* instance);
+
+    void (*init)(void* instance, u32 dsp, u32 sampleRate);
+    void (*instanceClear)(void* instance, u32 dsp);
+    void (*compute)(void* instance, u32 dsp, u32 count, u32 inputs, u32 outputs);
+    void (*setParamValue)(void* instance, u32 dsp, u32 index, f32 value);
+
+    /** The module's UI description, extracted at build time. */
+    const FaustWasmUiDescriptor& descriptor;
+};
+
+namespace FaustWasmRegistry
+{
+    int getNumModules() noexcept;
+    const FaustWasmModuleInfo& getModule(int index) noexcept;
+
+    /** The module registered under `name` (its wasm2c module name), or null. */
+    const FaustWasmModuleInfo* findModule(const char* name) noexcept;
+}
+
+/** Calls a wasm2c instantiate function. Modules with imports take the
+    import instances as well; Faust only imports host math from "env" (see
+    WasmEnv.cpp and WasmMath.h). */
+template <typename Module, typename Instantiate>
+void instantiateFaustWasmModule(Instantiate instantiate, Module* module, w2c_env* env)
+{
+    if constexpr (std::is_invocable_v<Instantiate, Module*, w2c_env*>)
+        instantiate(module, env);
+    else
+        instantiate(module);
+}
+
+//==============================================================================
+/**
+ * Owns one instance of a registered module: its storage, linear memory,
+ * imported math and lifetime. The `dsp` arguments are the DSP state's offset
+ * in linear memory.
+ */
+class FaustWasmInstance
+{
+public:
+    explicit FaustWasmInstance(const FaustWasmModuleInfo& moduleToUse);
+    ~FaustWasmInstance();
+
+    const FaustWasmModuleInfo& getModule() const noexcept { return module; }
+    wasm_rt_memory_t& getMemory() const noexcept { return *module.memory(storage); }
+
+    // None of the calls into the module are noexcept: with trap containment
+    // a trap in any of them leaves as a WasmTrap.
+
+    void init(u32 dsp, u32 sampleRate) { module.init(storage, dsp, sampleRate); }
+    void instanceClear(u32 dsp) { module.instanceClear(storage, dsp); }
+
+    void compute(u32 dsp, u32 count, u32 inputs, u32 outputs)
+    {
+        env.countCompute(count);
+        module.compute(storage, dsp, count, inputs, outputs);
+    }
+
+    void setParamValue(u32 dsp, u32 index, f32 value)
+    {
+        module.setParamValue(storage, dsp, index, value);
+    }
+
+    /** Picks the math this instance's imports run on; takes effect from the
+        next call into the module. */
+    void setMathProvider(const WasmMathProvider& provider) noexcept { env.math.store(&provider, std::memory_order_relaxed); }
+    const WasmMathProvider& getMathProvider() const noexcept { return *env.math.load(std::memory_order_relaxed); }
+
+    /** Import and compute call counts; see w2c_env. */
+    const w2c_env& getImportEnv() const noexcept { return env; }
+    void resetImportCounts() noexcept { env.resetCounts(); }
+
+private:
+    const FaustWasmModuleInfo& module;
+    w2c_env env;
+    void* storage = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(FaustWasmInstance)
+};
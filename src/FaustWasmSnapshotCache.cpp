@@ -0,0 +1,49 @@
+#include "FaustWasmSnapshotCache.h"
+
+#include <cstring>
+
+//==============================================================================
+FaustWasmSnapshotCache& FaustWasmSnapshotCache::getInstance()
+{
+    static FaustWasmSnapshotCache cache;
+    return cache;
+}
+
+void FaustWasmSnapshotCache::init(FaustWasmInstance& instance, u32 dsp, uint32_t stateBytes, u32 sampleRate)
+{
+    auto& memory = instance.getMemory();
+
+    if (stateBytes == 0 || (uint64_t)dsp + stateBytes > memory.size)
+    {
+        instance.init(dsp, sampleRate);
+        return;
+    }
+
+    const Key key { &instance.getModule(), dsp, stateBytes, sampleRate, &instance.getMathProvider() };
+    uint8_t* state = memory.data + dsp;
+
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        auto found = images.find(key);
+
+        if (found != images.end())
+        {
+            std::memcpy(state, found->second.data(), stateBytes);
+            return;
+        }
+    }
+
+    // First time at this rate: init for real (outside the lock, it may take
+    // a while) and keep the result
+    instance.init(dsp, sampleRate);
+    std::vector<uint8_t> image (state, state + stateBytes);
+
+    std::lock_guard<std::mutex> guard (lock);
+    images.emplace(key, std::move(image));
+}
+
+int FaustWasmSnapshotCache::getNumImages() const
+{
+    std::lock_guard<std::mutex> guard (lock);
+    return (int)images.size();
+}
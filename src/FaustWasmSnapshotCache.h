@@ -0,0 +1,44 @@
+#pragma once
+
+#include "FaustWasmRegistry.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+//==============================================================================
+/**
+ * Process-wide cache of initialised DSP state images, per module and sample
+ * rate.
+ *
+ * A Faust WASM module's init(sampleRate) only writes the DSP state at `dsp`
+ * (classInit's tables included) and keeps nothing in globals, so an
+ * initialised instance is fully described by those `size` bytes. The first
+ * init of a module at a rate runs the real thing and keeps the image; every
+ * later one, in any plugin instance, is a copy of it.
+ *
+ * Init may call the math imports (Faust computes constants there), so
+ * images are also keyed on the instance's math provider: one made with
+ * approximate math is never handed to an instance running exact math.
+ */
+class FaustWasmSnapshotCache
+{
+public:
+    static FaustWasmSnapshotCache& getInstance();
+
+    /** Leaves `instance` as instance.init(dsp, sampleRate) would. `stateBytes`
+        is the DSP size from the module's descriptor; 0 skips the cache.
+        Not realtime safe: may run init and allocate. */
+    void init(FaustWasmInstance& instance, u32 dsp, uint32_t stateBytes, u32 sampleRate);
+
+    int getNumImages() const;
+
+private:
+    FaustWasmSnapshotCache() = default;
+
+    // module, DSP offset, state size, sample rate, math provider
+    using Key = std::tuple<const FaustWasmModuleInfo*, u32, uint32_t, u32, const WasmMathProvider*>;
+
+    mutable std::mutex lock;
+    std::map<Key, std::vector<uint8_t>> images;
+};
@@ -0,0 +1,144 @@
+#include "Harmonizer.h"
+#include "PitchShifterKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+void Harmonizer::prepare(float maxWindowSamples)
+{
+    // Taps read less than 2w + 2 samples back, and the Faust code never reads
+    // further than maxDelaySamples. The line also holds the chunk written
+    // ahead of the reads.
+    maxWindow = juce::jlimit(1.0f, (float)((maxDelaySamples - 1) / 2), maxWindowSamples);
+    const int longestDelay = (int)std::ceil(2.0f * maxWindow) + 2;
+    const int newDelaySize = (int)juce::nextPowerOfTwo(longestDelay + chunkSize);
+
+    if (newDelaySize != delaySize)
+    {
+        // Fresh zeroed memory, so nothing is dirty yet
+        delayLine.allocate((size_t)newDelaySize, true);
+        delaySize = newDelaySize;
+        delayMask = delaySize - 1;
+        dirtySamples = 0;
+    }
+
+    // Existing taps keep their settings, limited to the new window range
+    for (auto& tap : taps)
+        tap.window = juce::jlimit(1.0f, maxWindow, tap.window);
+
+    reset();
+}
+
+void Harmonizer::reset() noexcept
+{
+    // Writes start at sample 0 after every clear, so only the samples up to
+    // the furthest write can be dirty
+    std::fill(delayLine.get(), delayLine.get() + dirtySamples, 0.0f);
+    dirtySamples = 0;
+    writePosition = 0;
+
+    for (auto& tap : taps)
+        tap.phase = 0.0f;
+}
+
+void Harmonizer::setTapParameters(int tap, float shiftSemitones, float windowSamples, float xfadeSamples, float level) noexcept
+{
+    jassert(juce::isPositiveAndBelow(tap, maxTaps));
+    auto& t = taps[(size_t)tap];
+
+    // With the Faust UI's shift range and the window limited to the line,
+    // the phasor only ever needs two subtractions to wrap and no tap can
+    // reach past the line, so the kernel needs neither fmod nor clamps
+    t.window = juce::jlimit(1.0f, juce::jmax(1.0f, maxWindow), windowSamples);
+    t.invXfade = 1.0f / juce::jlimit(1.0f, 10000.0f, xfadeSamples);
+    t.level = level;
+
+    // A window that shrank below the phase would break that, so wrap it now
+    if (t.phase >= t.window)
+        t.phase = std::fmod(t.phase, t.window);
+
+    shiftSemitones = juce::jlimit(-12.0f, 12.0f, shiftSemitones);
+    if (shiftSemitones != t.shift)
+    {
+        t.shift = shiftSemitones;
+        t.ratio = std::pow(2.0f, 0.083333336f * shiftSemitones);
+    }
+}
+
+void Harmonizer::setTapBus(int tap, int bus) noexcept
+{
+    jassert(juce::isPositiveAndBelow(tap, maxTaps));
+    taps[(size_t)tap].bus = bus;
+}
+
+//==============================================================================
+void Harmonizer::process(const float* input, float* const* busOutputs, int numBuses, int numSamples) noexcept
+{
+    jassert(numBuses <= maxTaps);
+    numBuses = juce::jmin(numBuses, maxTaps);
+
+    if (delaySize == 0 || numSamples <= 0)
+        return;
+
+    for (int bus = 0; bus < numBuses; ++bus)
+        if (busOutputs[bus] != nullptr)
+            juce::FloatVectorOperations::clear(busOutputs[bus], numSamples);
+
+    float* chunkOutputs[maxTaps];
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+    {
+        for (int bus = 0; bus < numBuses; ++bus)
+            chunkOutputs[bus] = busOutputs[bus] != nullptr ? busOutputs[bus] + offset : nullptr;
+
+        processChunk(input + offset, chunkOutputs, numBuses, juce::jmin(chunkSize, numSamples - offset));
+    }
+}
+
+void Harmonizer::processChunk(const float* input, float* const* busOutputs, int numBuses, int numSamples) noexcept
+{
+    // The whole chunk goes into the line before any tap reads it. The line
+    // is a chunk longer than the longest delay, so no sample a tap still
+    // needs gets overwritten.
+    for (int i = 0; i < numSamples; ++i)
+        delayLine[(writePosition + i) & delayMask] = input[i];
+
+    for (auto& tap : taps)
+    {
+        if (tap.level == 0.0f || !juce::isPositiveAndBelow(tap.bus, numBuses) || busOutputs[tap.bus] == nullptr)
+            continue;
+
+        processTap(tap, busOutputs[tap.bus], numSamples);
+    }
+
+    dirtySamples = juce::jmin(delaySize, dirtySamples + numSamples);
+    writePosition = (writePosition + numSamples) & delayMask;
+}
+
+void Harmonizer::processTap(Tap& tap, float* output, int numSamples) const noexcept
+{
+    const float* line = delayLine.get();
+    const int mask = delayMask;
+
+    const float fSlow0 = tap.window;
+    const float fSlow1 = tap.ratio;
+    const float fSlow2 = tap.invXfade;
+    const float level = tap.level;
+    float rec = tap.phase;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int iota = writePosition + i;
+
+        auto readTaps = [line, mask, iota] (int delayA, int delayB, PitchShifterKernel::Taps<float>& taps) noexcept
+        {
+            taps = { line[(iota - delayA) & mask], line[(iota - (delayA + 1)) & mask],
+                     line[(iota - delayB) & mask], line[(iota - (delayB + 1)) & mask] };
+        };
+
+        output[i] += level * PitchShifterKernel::step(rec, fSlow0, fSlow1, fSlow2, readTaps);
+    }
+
+    tap.phase = rec;
+}
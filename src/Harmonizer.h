@@ -0,0 +1,78 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * Several pitch shifter voices reading one shared delay line.
+ *
+ * When every voice is fed the same signal (the mono TS9 output), the
+ * pitchShifter's delay line is identical for all of them and only the read
+ * side differs. Here the input is written once and each tap runs its own
+ * phasor, shift, window, crossfade and level against that single line, so
+ * stacking more intervals costs reads, not memory or write bandwidth.
+ *
+ * Each tap is the Faust pitchShifter (fausts/pitchShifter.cpp) sample for
+ * sample, run by PitchShifterKernel::step, then scaled by its level and
+ * summed into one of the caller's buses.
+ * Taps at level 0 cost nothing.
+ */
+class Harmonizer
+{
+public:
+    static constexpr int maxTaps = 8;
+
+    // Longest delay a tap can read in the Faust code, in samples
+    static constexpr int maxDelaySamples = 65537;
+
+    // The input is written this many samples ahead of the reads
+    static constexpr int chunkSize = 128;
+
+    /** Allocates and clears the line for windows up to `maxWindowSamples`.
+        Not realtime safe, but cheap when the length does not change. */
+    void prepare(float maxWindowSamples);
+
+    /** Silences the delay line and resets the phases. Only the samples
+        written since the last clear are touched. */
+    void reset() noexcept;
+
+    /** Samples in the delay line, a power of two. */
+    int getDelaySize() const noexcept { return delaySize; }
+
+    /** Sets one tap's sliders; the same units as the Faust UI. The window is
+        limited to what the line was prepared for. `level` is a linear gain. */
+    void setTapParameters(int tap, float shiftSemitones, float windowSamples, float xfadeSamples, float level) noexcept;
+
+    /** Chooses which of the buses passed to process() the tap is added to. */
+    void setTapBus(int tap, int bus) noexcept;
+
+    /** Writes `numSamples` of `input` to the line and replaces each bus with
+        the sum of its taps. Taps whose bus is null or out of range are
+        skipped, their phases held. */
+    void process(const float* input, float* const* busOutputs, int numBuses, int numSamples) noexcept;
+
+private:
+    struct Tap
+    {
+        float phase = 0.0f;
+        float window = 1000.0f;     // fSlow0
+        float ratio = 1.0f;         // fSlow1 = 2^(shift / 12)
+        float invXfade = 0.1f;      // fSlow2
+        float shift = 0.0f;         // last shift, to skip the pow
+        float level = 0.0f;
+        int bus = 0;
+    };
+
+    void processChunk(const float* input, float* const* busOutputs, int numBuses, int numSamples) noexcept;
+    void processTap(Tap& tap, float* output, int numSamples) const noexcept;
+
+    std::array<Tap, maxTaps> taps;
+
+    juce::HeapBlock<float> delayLine;
+    int delaySize = 0;
+    int delayMask = 0;
+    int writePosition = 0;      // wraps at delaySize
+    int dirtySamples = 0;       // samples [0, dirtySamples) may be non-zero
+    float maxWindow = 0.0f;
+};
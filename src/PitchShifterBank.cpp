@@ -0,0 +1,230 @@
+#include "PitchShifterBank.h"
+#include "PitchShifterKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+void PitchShifterBank::prepare(int numVoicesToUse, float maxWindowSamples)
+{
+    numVoices = juce::jlimit(0, maxVoices, numVoicesToUse);
+    numGroups = (numVoices + laneGroupSize - 1) / laneGroupSize;
+
+    // The window is specified in samples, so the sample rate doesn't matter:
+    // both taps sit less than 2w + 2 samples back
+    const int longestDelay = juce::jmin(maxDelaySamples, (int)std::ceil(2.0f * juce::jmax(1.0f, maxWindowSamples)) + 2);
+    const int newDelaySize = (int)juce::nextPowerOfTwo(longestDelay + 1);
+
+    if (newDelaySize != delaySize || numGroups > allocatedGroups)
+    {
+        // Fresh zeroed pages, so nothing is dirty yet
+        constexpr size_t alignment = 64;
+        const size_t numFloats = (size_t)numGroups * (size_t)newDelaySize * laneGroupSize;
+        delayStorage.allocate(numFloats * sizeof(float) + alignment, true);
+        const auto address = reinterpret_cast<uintptr_t>(delayStorage.get());
+        delayLines = reinterpret_cast<float*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        allocatedGroups = numGroups;
+        dirtyFrames = 0;
+    }
+
+    delaySize = newDelaySize;
+    delayMask = delaySize - 1;
+    maxDelay = juce::jmin(maxDelaySamples, delaySize - 1);
+
+    // Faust UI defaults, so padding lanes compute something sane
+    for (int voice = 0; voice < maxVoices; ++voice)
+    {
+        shift[(size_t)voice] = 1.0f; // force the pow below
+        setVoiceParameters(voice, 0.0f, 1000.0f, 10.0f);
+    }
+
+    reset();
+}
+
+void PitchShifterBank::reset() noexcept
+{
+    // Writes start at frame 0 after every clear, so only the frames up to
+    // the furthest write can be dirty. Groups left over from a wider layout
+    // are cleared too, in case it grows back.
+    for (int group = 0; group < allocatedGroups && dirtyFrames > 0; ++group)
+    {
+        float* line = delayLines + (size_t)group * (size_t)delaySize * laneGroupSize;
+        std::fill(line, line + (size_t)dirtyFrames * laneGroupSize, 0.0f);
+    }
+
+    dirtyFrames = 0;
+    phase.fill(0.0f);
+    writePosition = 0;
+}
+
+void PitchShifterBank::setVoiceParameters(int voice, float shiftSemitones, float windowSamples, float xfadeSamples) noexcept
+{
+    jassert(juce::isPositiveAndBelow(voice, maxVoices));
+    const auto lane = (size_t)voice;
+
+    window[lane] = windowSamples;
+    invXfade[lane] = 1.0f / xfadeSamples;
+
+    // The kernel wraps the phasor with two subtractions, which needs the
+    // phase below the window. One that shrank below the phase (a ramp step,
+    // a jump, or a reset parameter after waking) would break that, so wrap
+    // it now.
+    if (phase[lane] >= windowSamples)
+        phase[lane] = std::fmod(phase[lane], windowSamples);
+
+    if (shiftSemitones != shift[lane])
+    {
+        shift[lane] = shiftSemitones;
+        ratio[lane] = std::pow(2.0f, 0.083333336f * shiftSemitones);
+    }
+}
+
+//==============================================================================
+void PitchShifterBank::process(const float* const* inputs, float* const* outputs, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    for (int group = 0; group < numGroups; ++group)
+        processGroup(group, inputs, outputs, numSamples);
+
+    dirtyFrames = juce::jmin(delaySize, dirtyFrames + numSamples);
+    writePosition = (writePosition + numSamples) & delayMask;
+}
+
+void PitchShifterBank::processGroup(int group, const float* const* inputs, float* const* outputs, int numSamples) noexcept
+{
+   #if FUZZAVER_PITCH_KERNEL_SIMD
+    processGroupSimd(group, inputs, outputs, numSamples);
+   #else
+    processGroupScalar(group, inputs, outputs, numSamples);
+   #endif
+}
+
+void PitchShifterBank::processGroupScalar(int group, const float* const* inputs, float* const* outputs, int numSamples) noexcept
+{
+    float* delay = delayLines + (size_t)group * (size_t)delaySize * laneGroupSize;
+
+    const int firstVoice = group * laneGroupSize;
+    const int lanesInUse = juce::jmin(laneGroupSize, numVoices - firstVoice);
+
+    float* groupPhase = phase.data() + firstVoice;
+    const float* groupWindow = window.data() + firstVoice;
+    const float* groupRatio = ratio.data() + firstVoice;
+    const float* groupInvXfade = invXfade.data() + firstVoice;
+
+    const float* groupInputs[laneGroupSize] = {};
+    float* groupOutputs[laneGroupSize] = {};
+    for (int lane = 0; lane < lanesInUse; ++lane)
+    {
+        groupInputs[lane] = inputs[firstVoice + lane];
+        groupOutputs[lane] = outputs[firstVoice + lane];
+    }
+
+    const int mask = delayMask;
+    const int longest = maxDelay;
+
+    float laneOutput[laneGroupSize];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int iota = writePosition + i;
+
+        // Padding lanes keep reading the silence they were cleared with
+        float* frame = delay + (iota & delayMask) * laneGroupSize;
+        for (int lane = 0; lane < lanesInUse; ++lane)
+            frame[lane] = groupInputs[lane][i];
+
+        // The SIMD path's step, one lane at a time
+        for (int lane = 0; lane < laneGroupSize; ++lane)
+        {
+            auto tap = [delay, mask, longest, iota, lane] (int delaySamples) noexcept
+            {
+                const int clamped = std::min<int>(longest, std::max<int>(0, delaySamples));
+                return delay[((iota - clamped) & mask) * laneGroupSize + lane];
+            };
+
+            auto readTaps = [&tap] (int delayA, int delayB, PitchShifterKernel::Taps<float>& taps) noexcept
+            {
+                taps = { tap(delayA), tap(delayA + 1), tap(delayB), tap(delayB + 1) };
+            };
+
+            laneOutput[lane] = PitchShifterKernel::step(groupPhase[lane], groupWindow[lane], groupRatio[lane], groupInvXfade[lane], readTaps);
+        }
+
+        for (int lane = 0; lane < lanesInUse; ++lane)
+            groupOutputs[lane][i] = laneOutput[lane];
+    }
+}
+
+#if FUZZAVER_PITCH_KERNEL_SIMD
+void PitchShifterBank::processGroupSimd(int group, const float* const* inputs, float* const* outputs, int numSamples) noexcept
+{
+    static_assert(laneGroupSize == 4, "The SIMD kernel handles one 4-lane register per group");
+
+    float* delay = delayLines + (size_t)group * (size_t)delaySize * laneGroupSize;
+
+    const int firstVoice = group * laneGroupSize;
+    const int lanesInUse = juce::jmin(laneGroupSize, numVoices - firstVoice);
+
+    const float* groupInputs[laneGroupSize] = {};
+    float* groupOutputs[laneGroupSize] = {};
+    for (int lane = 0; lane < lanesInUse; ++lane)
+    {
+        groupInputs[lane] = inputs[firstVoice + lane];
+        groupOutputs[lane] = outputs[firstVoice + lane];
+    }
+
+    using namespace PitchShifterKernel;
+
+    const Vec fSlow0 = load(window.data() + firstVoice);
+    const Vec fSlow1 = load(ratio.data() + firstVoice);
+    const Vec fSlow2 = load(invXfade.data() + firstVoice);
+    Vec rec = load(phase.data() + firstVoice);
+
+    alignas(16) int delayA[laneGroupSize];
+    alignas(16) int delayB[laneGroupSize];
+    alignas(16) float tapA0[laneGroupSize], tapA1[laneGroupSize], tapB0[laneGroupSize], tapB1[laneGroupSize];
+    alignas(16) float laneOutput[laneGroupSize];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int iota = writePosition + i;
+
+        // Padding lanes keep reading the silence they were cleared with
+        float* frame = delay + (iota & delayMask) * laneGroupSize;
+        for (int lane = 0; lane < lanesInUse; ++lane)
+            frame[lane] = groupInputs[lane][i];
+
+        // The four taps per lane are gathers: each lane reads its own delay
+        const Vec output = step(rec, fSlow0, fSlow1, fSlow2, [&] (IntVec delaysA, IntVec delaysB, auto& taps) noexcept
+        {
+            store(delayA, delaysA);
+            store(delayB, delaysB);
+
+            for (int lane = 0; lane < laneGroupSize; ++lane)
+            {
+                auto tap = [&] (int delaySamples) noexcept
+                {
+                    const int clamped = std::min<int>(maxDelay, std::max<int>(0, delaySamples));
+                    return delay[((iota - clamped) & delayMask) * laneGroupSize + lane];
+                };
+
+                tapA0[lane] = tap(delayA[lane]);
+                tapA1[lane] = tap(delayA[lane] + 1);
+                tapB0[lane] = tap(delayB[lane]);
+                tapB1[lane] = tap(delayB[lane] + 1);
+            }
+
+            taps = { load(tapA0), load(tapA1), load(tapB0), load(tapB1) };
+        });
+
+        store(laneOutput, output);
+
+        for (int lane = 0; lane < lanesInUse; ++lane)
+            groupOutputs[lane][i] = laneOutput[lane];
+    }
+
+    store(phase.data() + firstVoice, rec);
+}
+#endif
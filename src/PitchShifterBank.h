@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * One pitch shifter voice per channel, laid out structure-of-arrays.
+ *
+ * The algorithm is the Faust pitchShifter (fausts/pitchShifter.cpp) sample for
+ * sample, but voices are grouped into lanes of `laneGroupSize`: each group has
+ * one delay line with the lanes interleaved ([position][lane]) and its phases
+ * and parameters in contiguous per-lane arrays. A group's inner loop is the
+ * same arithmetic on adjacent lanes, so 4/8/16 channels run as 1/2/4 lane
+ * groups instead of that many separate mydsp::compute calls.
+ *
+ * Each lane runs PitchShifterKernel::step. With SSE2 or NEON a lane group is
+ * one register: the phasors, fmod and interpolation weights of all four lanes
+ * advance together and only the delay taps are gathered per lane. Stereo uses
+ * a single group.
+ *
+ * The delay lines are sized for the largest window the voices will be given
+ * rather than the Faust code's fixed 128K samples, and clearing them only
+ * touches the frames written since the last clear.
+ */
+class PitchShifterBank
+{
+public:
+    static constexpr int maxVoices = 16;
+    static constexpr int laneGroupSize = 4;
+
+    // Longest delay a tap can read in the Faust code, in samples
+    static constexpr int maxDelaySamples = 65537;
+
+    /** Allocates and clears the voices for windows up to `maxWindowSamples`.
+        Not realtime safe, but cheap when the geometry does not change. */
+    void prepare(int numVoicesToUse, float maxWindowSamples);
+
+    /** Silences the delay lines and resets the phases. Only the frames
+        written since the last clear are touched. */
+    void reset() noexcept;
+
+    /** Samples per delay line, a power of two. */
+    int getDelaySize() const noexcept { return delaySize; }
+
+    int getNumVoices() const noexcept { return numVoices; }
+
+    /** Sets one voice's sliders; the same units as the Faust UI. */
+    void setVoiceParameters(int voice, float shiftSemitones, float windowSamples, float xfadeSamples) noexcept;
+
+    /** Runs every voice over `numSamples`. `inputs` and `outputs` hold one
+        pointer per voice; a voice may read and write the same buffer. */
+    void process(const float* const* inputs, float* const* outputs, int numSamples) noexcept;
+
+private:
+
+    void processGroup(int group, const float* const* inputs, float* const* outputs, int numSamples) noexcept;
+    void processGroupScalar(int group, const float* const* inputs, float* const* outputs, int numSamples) noexcept;
+    void processGroupSimd(int group, const float* const* inputs, float* const* outputs, int numSamples) noexcept;
+
+    int numVoices = 0;
+    int numGroups = 0;
+    int writePosition = 0;     // wraps at delaySize
+    int dirtyFrames = 0;       // frames [0, dirtyFrames) may hold non-zero samples
+
+    // Delay line geometry: the taps of a window w reach back 2w + 1 samples
+    int delaySize = 0;
+    int delayMask = 0;
+    int maxDelay = 0;          // maxDelaySamples, or less if the line is shorter
+
+    // [group][delaySize][laneGroupSize], cache-line aligned
+    juce::HeapBlock<char> delayStorage;
+    float* delayLines = nullptr;
+    int allocatedGroups = 0;
+
+    // Per-lane state and control values, padded to whole lane groups
+    alignas(16) std::array<float, maxVoices> phase {};
+    alignas(16) std::array<float, maxVoices> window {};     // fSlow0
+    alignas(16) std::array<float, maxVoices> ratio {};      // fSlow1 = 2^(shift / 12)
+    alignas(16) std::array<float, maxVoices> invXfade {};   // fSlow2
+    std::array<float, maxVoices> shift {};                  // last shift, to skip the pow
+};
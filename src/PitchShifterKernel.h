@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define FUZZAVER_PITCH_KERNEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define FUZZAVER_PITCH_KERNEL_NEON 1
+#endif
+
+#if FUZZAVER_PITCH_KERNEL_SSE2 || FUZZAVER_PITCH_KERNEL_NEON
+ #define FUZZAVER_PITCH_KERNEL_SIMD 1
+#endif
+
+//==============================================================================
+/**
+ * One sample of the Faust pitchShifter (fausts/pitchShifter.cpp), shared by
+ * the PitchShifterBank voices, the Harmonizer taps and FastPitchShifter.
+ *
+ * The phasor moves by a constant step each sample, which the generated code
+ * does not exploit. step() is mydsp::compute's loop body, strength-reduced:
+ *  - the fmod becomes at most two subtractions of the window: with the phase
+ *    below the window, w >= 1 and the ratio within [0.5, 2] (the Faust UI's
+ *    shift range) its argument lies in (w - 1, 2w + 1), and both subtractions
+ *    are exact, so the phasor follows mydsp bit for bit;
+ *  - the floors and int casts of the (non-negative) read positions become
+ *    one truncation each;
+ *  - the tap clamps leave the loop: the phasor stays in [0, w), so all taps
+ *    lie in [0, 2w + 1), and callers whose line is longer than that read
+ *    without them.
+ *
+ * The crossfade is deliberately not made incremental. It is one multiply,
+ * and the phasor's real step is quantised by the window's magnitude, so a
+ * ramp accumulated from the nominal step drifts from mydsp by percents within
+ * a window.
+ *
+ * The rest is mydsp's expressions in mydsp's order, so the output matches it
+ * to float rounding; it is not bit-identical only because the compiler may
+ * contract a different set of multiply-adds into FMAs.
+ *
+ * The step is written once over `float` and, with SSE2 or NEON, over a
+ * 4-lane register, where the phasors of four voices advance together and
+ * only the delay taps are gathered per lane.
+ */
+namespace PitchShifterKernel
+{
+    // The operations step() is written in, for one lane...
+    template <typename Float> Float splat(float x) noexcept;
+
+    template <> inline float splat<float>(float x) noexcept   { return x; }
+    inline float add(float a, float b) noexcept                { return a + b; }
+    inline float sub(float a, float b) noexcept                { return a - b; }
+    inline float mul(float a, float b) noexcept                { return a * b; }
+    inline float min(float a, float b) noexcept                { return std::min<float>(a, b); }
+    inline float subWhereAtLeast(float x, float w) noexcept    { return x >= w ? x - w : x; }
+    inline int truncate(float x) noexcept                      { return static_cast<int>(x); }
+    inline float toFloat(int x) noexcept                       { return static_cast<float>(x); }
+
+    // ...and for four
+   #if FUZZAVER_PITCH_KERNEL_SSE2
+    using Vec = __m128;
+    using IntVec = __m128i;
+
+    template <> inline Vec splat<Vec>(float x) noexcept        { return _mm_set1_ps(x); }
+    inline Vec load(const float* p) noexcept                   { return _mm_load_ps(p); }
+    inline void store(float* p, Vec v) noexcept                { _mm_store_ps(p, v); }
+    inline void store(int* p, IntVec v) noexcept               { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    inline Vec add(Vec a, Vec b) noexcept                      { return _mm_add_ps(a, b); }
+    inline Vec sub(Vec a, Vec b) noexcept                      { return _mm_sub_ps(a, b); }
+    inline Vec mul(Vec a, Vec b) noexcept                      { return _mm_mul_ps(a, b); }
+    inline Vec min(Vec a, Vec b) noexcept                      { return _mm_min_ps(a, b); }
+    inline Vec subWhereAtLeast(Vec x, Vec w) noexcept          { return _mm_sub_ps(x, _mm_and_ps(_mm_cmpge_ps(x, w), w)); }
+    inline IntVec truncate(Vec v) noexcept                     { return _mm_cvttps_epi32(v); }
+    inline Vec toFloat(IntVec v) noexcept                      { return _mm_cvtepi32_ps(v); }
+   #elif FUZZAVER_PITCH_KERNEL_NEON
+    using Vec = float32x4_t;
+    using IntVec = int32x4_t;
+
+    template <> inline Vec splat<Vec>(float x) noexcept        { return vdupq_n_f32(x); }
+    inline Vec load(const float* p) noexcept                   { return vld1q_f32(p); }
+    inline void store(float* p, Vec v) noexcept                { vst1q_f32(p, v); }
+    inline void store(int* p, IntVec v) noexcept               { vst1q_s32(p, v); }
+    inline Vec add(Vec a, Vec b) noexcept                      { return vaddq_f32(a, b); }
+    inline Vec sub(Vec a, Vec b) noexcept                      { return vsubq_f32(a, b); }
+    inline Vec mul(Vec a, Vec b) noexcept                      { return vmulq_f32(a, b); }
+    inline Vec min(Vec a, Vec b) noexcept                      { return vminq_f32(a, b); }
+    inline Vec subWhereAtLeast(Vec x, Vec w) noexcept
+    {
+        return vsubq_f32(x, vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(x, w), vreinterpretq_u32_f32(w))));
+    }
+    inline IntVec truncate(Vec v) noexcept                     { return vcvtq_s32_f32(v); }
+    inline Vec toFloat(IntVec v) noexcept                      { return vcvtq_f32_s32(v); }
+   #endif
+
+    /** The four delay line samples one step reads. */
+    template <typename Float>
+    struct Taps
+    {
+        Float a0, a1;    // `delayA` and `delayA + 1` samples back
+        Float b0, b1;    // `delayB` and `delayB + 1` samples back
+    };
+
+    /** Advances `phase` (fRec0) by one sample and returns the shifted output.
+        `window`, `ratio` and `invXfade` are mydsp's fSlow0, fSlow1 and fSlow2.
+
+        `readTaps (delayA, delayB, taps)` fills in the Taps for the current
+        write position, the delays being ints or, for Vec, an IntVec; the
+        sample being written must already be in the line. The phase must be below
+        the window when called, and stays so. */
+    template <typename Float, typename ReadTaps>
+    inline Float step(Float& phase, Float window, Float ratio, Float invXfade, ReadTaps&& readTaps) noexcept
+    {
+        const Float one = splat<Float>(1.0f);
+
+        // fmod(w + (rec + 1 - ratio), w)
+        Float x = add(window, sub(add(phase, one), ratio));
+        x = subWhereAtLeast(x, window);
+        const Float rec = subWhereAtLeast(x, window);
+        phase = rec;
+
+        // Every operand is non-negative, so truncation is floor
+        const auto iTemp1 = truncate(rec);
+        const Float fTemp2 = toFloat(iTemp1);
+        const Float fTemp3 = sub(one, rec);
+        const Float fTemp4 = min(mul(invXfade, rec), one);
+        const Float fTemp5 = add(window, rec);
+        const auto iTemp6 = truncate(fTemp5);
+        const Float fTemp7 = toFloat(iTemp6);
+
+        Taps<Float> taps;
+        readTaps(iTemp1, iTemp6, taps);
+
+        const Float first = add(mul(taps.a0, add(fTemp2, fTemp3)), mul(sub(rec, fTemp2), taps.a1));
+        const Float second = add(mul(taps.b0, sub(add(fTemp7, fTemp3), window)), mul(add(window, sub(rec, fTemp7)), taps.b1));
+        return add(mul(first, fTemp4), mul(second, sub(one, fTemp4)));
+    }
+}
@@ -1,16 +1,20 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include "BinaryData.h"
 
-#include <juce_audio_formats/juce_audio_formats.h>
 #include <chrono>
 #include <vector>
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 
+// Which TS9 backend new instances start with; set by CMake (FUZZAVER_TS9_NATIVE)
+#ifndef FUZZAVER_TS9_NATIVE_DEFAULT
+ #define FUZZAVER_TS9_NATIVE_DEFAULT 0
+#endif
+
 //==============================================================================
 juce::AudioProcessor::BusesProperties AudioPluginAudioProcessor::createBusesProperties()
 {
@@ -28,147 +32,101 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
      : AudioProcessor (createBusesProperties())
 {    
     // Initialize TS9 WASM module
-    createTS9ParametersAndInitWasm(*this, ts9WasmApp, ts9WasmMemory, ts9ParameterIndexMap);
+    createTS9ParametersAndInitWasm(*this, ts9Engine);
     
     // Load the WAV file from binary data
-    std::cout << "Loading audio file from binary data..." << std::endl;
-    
-    int dataSize = 0;
-    const char* data = BinaryData::getNamedResource("RawGTR_wav", dataSize);
-    
-    if (data != nullptr && dataSize > 0)
-    {
-        std::cout << "Binary data found: " << dataSize << " bytes" << std::endl;
-        
-        juce::AudioFormatManager formatManager;
-        formatManager.registerBasicFormats();
-        
-        auto inputStream = std::make_unique<juce::MemoryInputStream>(data, dataSize, false);
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(std::move(inputStream)));
-        
-        if (reader != nullptr)
-        {
-            std::cout << "Audio file loaded successfully!" << std::endl;
-            std::cout << "  Sample rate: " << reader->sampleRate << std::endl;
-            std::cout << "  Num channels: " << reader->numChannels << std::endl;
-            std::cout << "  Length in samples: " << reader->lengthInSamples << std::endl;
-            std::cout << "  Duration: " << (reader->lengthInSamples / reader->sampleRate) << " seconds" << std::endl;
-            
-            audioFileBuffer.setSize(reader->numChannels, (int)reader->lengthInSamples);
-            reader->read(&audioFileBuffer, 0, (int)reader->lengthInSamples, 0, true, true);
-            
-            std::cout << "Audio file loaded into buffer" << std::endl;
-        }
-        else
-        {
-            std::cout << "ERROR: Could not create audio reader!" << std::endl;
-        }
-    }
-    else
-    {
-        std::cout << "ERROR: Binary data not found!" << std::endl;
-    }
+    wavFileSource.loadFromBinaryData("RawGTR_wav");
     
     // Create parameters
     addParameter(useWavFileParam = new juce::AudioParameterBool("useWavFile", "Use WAV File", true));
+    addParameter(ts9PerChannelParam = new juce::AudioParameterBool("ts9PerChannel", "TS9 Per-Channel", false));
+    addParameter(ts9NativeParam = new juce::AudioParameterBool("ts9Native", "TS9 Native Engine", FUZZAVER_TS9_NATIVE_DEFAULT != 0));
+    
+    // In WasmMath::Accuracy order. A setting for the session rather than
+    // something to sweep, so hosts don't offer it for automation.
+    addParameter(ts9MathAccuracyParam = new juce::AudioParameterChoice("ts9MathAccuracy", "TS9 Math Accuracy",
+                                                                       juce::StringArray { "Exact", "Polynomial", "Table" },
+                                                                       (int)WasmMath::getDefaultAccuracy(),
+                                                                       juce::AudioParameterChoiceAttributes().withAutomatable(false)));
     addParameter(leftShiftParam = new juce::AudioParameterFloat("leftShift", "Left Shift (semitones)", -12.0f, 12.0f, -12.0f));
     addParameter(rightShiftParam = new juce::AudioParameterFloat("rightShift", "Right Shift (semitones)", -12.0f, 12.0f, 12.0f));
     addParameter(leftWindowParam = new juce::AudioParameterFloat("leftWindow", "Left Window (samples)", 50.0f, 10000.0f, 2500.0f));
     addParameter(rightWindowParam = new juce::AudioParameterFloat("rightWindow", "Right Window (samples)", 50.0f, 10000.0f, 2500.0f));
     addParameter(leftXfadeParam = new juce::AudioParameterFloat("leftXfade", "Left Xfade (samples)", 1.0f, 10000.0f, 1500.0f));
     addParameter(rightXfadeParam = new juce::AudioParameterFloat("rightXfade", "Right Xfade (samples)", 1.0f, 10000.0f, 1500.0f));
+    
+    // Harmony voices, silent until their level is raised
+    const float harmonyShifts[numHarmonyVoices] = { 3.0f, 5.0f, 7.0f, -5.0f };
+    
+    for (int index = 0; index < numHarmonyVoices; ++index)
+    {
+        auto& voice = harmonyVoices[(size_t)index];
+        const juce::String id = "harmony" + juce::String(index + 1);
+        const juce::String name = "Harmony " + juce::String(index + 1);
+        
+        addParameter(voice.shiftParam = new juce::AudioParameterFloat(id + "Shift", name + " Shift (semitones)", -12.0f, 12.0f, harmonyShifts[index]));
+        addParameter(voice.windowParam = new juce::AudioParameterFloat(id + "Window", name + " Window (samples)", 50.0f, 10000.0f, 2500.0f));
+        addParameter(voice.xfadeParam = new juce::AudioParameterFloat(id + "Xfade", name + " Xfade (samples)", 1.0f, 10000.0f, 1500.0f));
+        addParameter(voice.levelParam = new juce::AudioParameterFloat(id + "Level", name + " Level", 0.0f, 1.0f, 0.0f));
+        
+        harmonizer.setTapBus(firstHarmonyTap + index, harmonyBus);
+    }
+    
+    harmonizer.setTapBus(leftTap, leftBus);
+    harmonizer.setTapBus(rightTap, rightBus);
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
-    wasm2c_ts9_free(&ts9WasmApp);
 }
 
 //==============================================================================
 void AudioPluginAudioProcessor::createTS9ParametersAndInitWasm(juce::AudioProcessor& processor,
-                                                                w2c_ts9& wasm_app,
-                                                                wasm_rt_memory_t*& wasm_memory,
-                                                                std::map<juce::String, int>& parameterIndexMap)
+                                                                Ts9Engine& engine)
 {
     std::cout << "=== TS9 WASM Initialization ===" << std::endl;
     
-    // Initialize WASM runtime and module
-    wasm_rt_init();
-    wasm2c_ts9_instantiate(&wasm_app, wasm_app.w2c_env_instance);
-    wasm_memory = w2c_ts9_memory(&wasm_app);
+    // The module's UI description was extracted from the .wasm at build time,
+    // so this is a walk over a static table
+    auto& wasm_memory = engine.getPrimaryMemory();
+    auto& parameterBindings = engine.getParameterBindings();
+    const auto& descriptor = engine.getDescriptor();
     
-    std::cout << "WASM memory size: " << wasm_memory->size << " bytes" << std::endl;
+    std::cout << "WASM memory size: " << wasm_memory.size << " bytes" << std::endl;
     
-    // Read JSON metadata from WASM memory BEFORE calling init
-    const char* json_cstr = (const char*)(wasm_memory->data);
-    juce::String jsonString(json_cstr);
-    
-    std::cout << "JSON length: " << jsonString.length() << std::endl;
-    
-    // Parse JSON
-    auto json = juce::JSON::parse(jsonString);
-    if (!json.isObject())
-    {
-        std::cout << "ERROR: JSON is not an object!" << std::endl;
-        return;
-    }
-    
-    auto uiArray = json.getProperty("ui", juce::var()).getArray();
-    if (uiArray == nullptr || uiArray->size() == 0)
+    if (!descriptor.isValid())
     {
-        std::cout << "ERROR: UI array not found or empty!" << std::endl;
+        std::cout << "ERROR: TS9 module has no usable JSON description!" << std::endl;
         return;
     }
     
-    std::cout << "Found UI array with " << uiArray->size() << " items" << std::endl;
+    // The DSP state lives at offset 0 and is `size` bytes long. Host buffers
+    // must stay clear of both the DSP state and the (soon dead) JSON blob.
+    const uint32_t reservedBytes = descriptor.getReservedBytes();
+    engine.setReservedBytes(reservedBytes);
+    std::cout << "JSON length: " << descriptor.jsonBytes << ", DSP size: " << descriptor.dspSize
+              << " bytes, reserved: " << reservedBytes << " bytes" << std::endl;
+    std::cout << "Found " << descriptor.numControls << " controls" << std::endl;
     
-    // Get the first vgroup (TS9_OverdriveFaustGenerated)
-    auto vgroup = (*uiArray)[0];
-    auto items = vgroup.getProperty("items", juce::var()).getArray();
-    if (items == nullptr)
+    for (const auto& control : descriptor)
     {
-        std::cout << "ERROR: Items array not found!" << std::endl;
-        return;
-    }
-    
-    std::cout << "Found " << items->size() << " top-level items" << std::endl;
-    
-    // Recursive function to process all parameters
-    std::function<void(const juce::var&)> processUIItem = [&](const juce::var& item) {
-        juce::String type = item.getProperty("type", "").toString();
-        juce::String label = item.getProperty("label", "").toString();
+        const juce::String type (control.type);
+        const juce::String label (control.label);
         
-        // If this is a group (hgroup/vgroup), process its items recursively
-        if (type == "hgroup" || type == "vgroup")
-        {
-            std::cout << "Found group: " << label << std::endl;
-            auto groupItems = item.getProperty("items", juce::var()).getArray();
-            if (groupItems != nullptr)
-            {
-                for (auto& groupItem : *groupItems)
-                {
-                    processUIItem(groupItem);
-                }
-            }
-            return;
-        }
+        std::cout << "Processing param: " << label << " (type: " << type << ", index: " << control.index << ")" << std::endl;
         
-        // Process actual controls (sliders, checkboxes, etc.)
-        int index = item.getProperty("index", -1);
-        
-        if (index == -1)
+        // Parameter zones are floats inside the DSP state
+        if ((uint64_t)control.index + sizeof(float) > reservedBytes)
         {
-            std::cout << "WARNING: Item " << label << " has no index!" << std::endl;
-            return;
+            std::cout << "WARNING: Item " << label << " has an index outside the DSP state!" << std::endl;
+            continue;
         }
         
-        std::cout << "Processing param: " << label << " (type: " << type << ", index: " << index << ")" << std::endl;
-        
         if (type == "hslider" || type == "vslider")
         {
-            float minVal = item.getProperty("min", 0.0f);
-            float maxVal = item.getProperty("max", 1.0f);
-            float initVal = item.getProperty("init", 0.0f);
+            float minVal = control.min;
+            float maxVal = control.max;
+            float initVal = control.init;
             
             // Override with custom defaults
             if (label == "drive") initVal = 1.0f;
@@ -177,12 +135,10 @@ void AudioPluginAudioProcessor::createTS9ParametersAndInitWasm(juce::AudioProces
             
             std::cout << "  Range: " << minVal << " to " << maxVal << ", default: " << initVal << std::endl;
             
-            parameterIndexMap[label] = index;
-            
             // Add "TS9_" prefix to avoid conflicts with pitch shifter params
             juce::String paramID = "ts9_" + label;
             
-            auto param = std::make_unique<juce::AudioParameterFloat>(
+            auto* param = new juce::AudioParameterFloat(
                 juce::ParameterID{paramID, 1},
                 "TS9 " + label,
                 minVal,
@@ -190,72 +146,29 @@ void AudioPluginAudioProcessor::createTS9ParametersAndInitWasm(juce::AudioProces
                 initVal
             );
             
-            processor.addParameter(param.release());
+            processor.addParameter(param);
+            parameterBindings.add(*param, control.index, false);
             std::cout << "  Added float parameter: " << paramID << std::endl;
-            
-            // Set the default value in WASM
-            w2c_ts9_setParamValue(&wasm_app, 0, index, initVal);
         }
         else if (type == "checkbox")
         {
-            parameterIndexMap[label] = index;
-            
             juce::String paramID = "ts9_" + label;
             
-            auto param = std::make_unique<juce::AudioParameterBool>(
+            auto* param = new juce::AudioParameterBool(
                 juce::ParameterID{paramID, 1},
                 "TS9 " + label,
                 false
             );
             
-            processor.addParameter(param.release());
+            processor.addParameter(param);
+            parameterBindings.add(*param, control.index, true);
             std::cout << "  Added bool parameter: " << paramID << std::endl;
-            
-            w2c_ts9_setParamValue(&wasm_app, 0, index, 0.0f);
         }
-    };
-    
-    // Process all items recursively
-    for (auto& item : *items)
-    {
-        processUIItem(item);
     }
     
     std::cout << "Initializing TS9 WASM with default parameters..." << std::endl;
-    w2c_ts9_init(&wasm_app, 512, 48000);
-    
-    // Re-set all default values after init
-    std::cout << "Re-setting default values after init..." << std::endl;
-    for (auto* param : processor.getParameters())
-    {
-        juce::String paramName = param->getName(100);
-        
-        // Only process TS9 parameters
-        if (!paramName.startsWith("TS9 "))
-            continue;
-            
-        // Remove "TS9 " prefix to get original label
-        juce::String originalLabel = paramName.substring(4);
-        
-        if (parameterIndexMap.count(originalLabel) > 0)
-        {
-            int wasmIndex = parameterIndexMap[originalLabel];
-            float value = 0.0f;
-            
-            if (auto* floatParam = dynamic_cast<juce::AudioParameterFloat*>(param))
-            {
-                juce::NormalisableRange<float> range = floatParam->getNormalisableRange();
-                value = range.convertFrom0to1(param->getValue());
-            }
-            else if (auto* boolParam = dynamic_cast<juce::AudioParameterBool*>(param))
-            {
-                value = boolParam->get() ? 1.0f : 0.0f;
-            }
-            
-            w2c_ts9_setParamValue(&wasm_app, 0, wasmIndex, value);
-            std::cout << "  [" << originalLabel << "] = " << value << std::endl;
-        }
-    }
+    // Init resets the controls, so the engine pushes all default values after it
+    engine.initialisePrimary(48000);
     std::cout << "TS9 Initialization complete." << std::endl;
 }
 
@@ -294,7 +207,23 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
 
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return (double)getTailSamples() / currentSampleRate;
+}
+
+int64_t AudioPluginAudioProcessor::getTailSamples() const
+{
+    // A voice reads at most two windows back (its phase is below one window
+    // and the second tap sits a window further), capped by the delay line.
+    // The crossfade only blends those taps, so it adds nothing.
+    float window = juce::jmax(leftWindowParam->get(), rightWindowParam->get());
+    for (const auto& voice : harmonyVoices)
+        if (voice.levelParam->get() > 0.0f)
+            window = juce::jmax(window, voice.windowParam->get());
+    
+    const int64_t pitchTail = juce::jmin((int64_t)(2.0f * window) + 2, (int64_t)PitchShifterBank::maxDelaySamples + 1);
+    
+    // The shifters are fed by the TS9, so its ringing comes on top
+    return pitchTail + (int64_t)std::ceil(Ts9Engine::tailSeconds * currentSampleRate);
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -331,55 +260,45 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     std::cout << "Sample Rate: " << sampleRate << std::endl;
     std::cout << "Samples Per Block: " << samplesPerBlock << std::endl;
     
-    // Re-initialize TS9 WASM with correct sample rate and buffer size
+    currentSampleRate = sampleRate;
+    
+    // Re-initialize TS9 WASM with correct sample rate, one instance per
+    // output channel so per-channel mode can be switched on at any time.
+    // The engine restores the parameter values after the re-init.
     std::cout << "Re-initializing TS9 WASM..." << std::endl;
-    w2c_ts9_init(&ts9WasmApp, float(samplesPerBlock), float(sampleRate));
+    ts9Engine.prepare(sampleRate, getTotalNumOutputChannels(), processingQuantum, ControlRamp::subBlockSize);
     
-    // Restore TS9 parameter values after re-init
-    std::cout << "Restoring TS9 parameter values..." << std::endl;
-    for (auto* param : getParameters())
-    {
-        juce::String paramName = param->getName(100);
-        
-        // Only process TS9 parameters
-        if (!paramName.startsWith("TS9 "))
-            continue;
-            
-        // Remove "TS9 " prefix
-        juce::String originalLabel = paramName.substring(4);
-        
-        if (ts9ParameterIndexMap.count(originalLabel) > 0)
-        {
-            int wasmIndex = ts9ParameterIndexMap[originalLabel];
-            float value = 0.0f;
-            
-            if (auto* floatParam = dynamic_cast<juce::AudioParameterFloat*>(param))
-            {
-                juce::NormalisableRange<float> range = floatParam->getNormalisableRange();
-                value = range.convertFrom0to1(param->getValue());
-            }
-            else if (auto* boolParam = dynamic_cast<juce::AudioParameterBool*>(param))
-            {
-                value = boolParam->get() ? 1.0f : 0.0f;
-            }
-            
-            w2c_ts9_setParamValue(&ts9WasmApp, 0, wasmIndex, value);
-        }
-    }
-    std::cout << "TS9 parameter restoration complete." << std::endl;
+    // Initialize pitch shifters: the shared line for the mono TS9 output, and
+    // one voice per output channel for per-channel mode
+    float maxWindow = juce::jmax(leftWindowParam->getNormalisableRange().end,
+                                 rightWindowParam->getNormalisableRange().end);
+    for (const auto& voice : harmonyVoices)
+        maxWindow = juce::jmax(maxWindow, voice.windowParam->getNormalisableRange().end);
     
-    // Initialize pitch shifters
-    pitchShifterLeft.init(static_cast<int>(sampleRate));
-    pitchShifterRight.init(static_cast<int>(sampleRate));
+    harmonizer.prepare(maxWindow);
+    harmonizerBuses.setSize(numHarmonizerBuses, processingQuantum);
+    harmonizerInput.setSize(1, processingQuantum);
+    pitchShifterBank.prepare(getTotalNumOutputChannels(),
+                             juce::jmax(leftWindowParam->getNormalisableRange().end,
+                                        rightWindowParam->getNormalisableRange().end));
+    pitchBankInUse = false;
     
     // Set pitch shift parameters from current parameter values
-    pitchShifterLeft.fHslider1 = *leftShiftParam;    // shift (semitones)
-    pitchShifterLeft.fHslider0 = *leftWindowParam;   // window (samples)
-    pitchShifterLeft.fHslider2 = *leftXfadeParam;    // xfade (samples)
+    leftPitchRamps.reset(*leftShiftParam, *leftWindowParam, *leftXfadeParam);
+    rightPitchRamps.reset(*rightShiftParam, *rightWindowParam, *rightXfadeParam);
+    for (auto& voice : harmonyVoices)
+        voice.reset();
+    applyPitchParameters();
+    
+    // Input sources
+    hostInputSource.setNumInputChannels(getTotalNumInputChannels());
+    
+    // Host blocks of any size are rechunked into fixed quanta, at the cost
+    // of one quantum of latency
+    rechunker.prepare(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()), processingQuantum);
+    setLatencySamples(rechunker.getLatencySamples());
     
-    pitchShifterRight.fHslider1 = *rightShiftParam;  // shift (semitones)
-    pitchShifterRight.fHslider0 = *rightWindowParam; // window (samples)
-    pitchShifterRight.fHslider2 = *rightXfadeParam;  // xfade (samples)
+    silenceGate.reset();
 }
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -394,12 +313,10 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout works (quad, 5.1, 7.1.4, ...) as long as every channel gets
+    // its own pitch shifter voice.
+    const int numOutputChannels = layouts.getMainOutputChannelSet().size();
+    if (numOutputChannels < 1 || numOutputChannels > PitchShifterBank::maxVoices)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -430,283 +347,298 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Check if we should use WAV file or real audio input
-    bool useWavFile = useWavFileParam->get();
+    // Nothing has been prepared yet (or the WASM layout failed), so there is
+    // nowhere to process into
+    if (ts9Engine.getNumPrepared() == 0)
+        return;
+
+    // ===== STAGE 1: Pick the source =====
+    // Check if we should use WAV file or real audio input. If the WAV file is
+    // selected but could not be loaded, the block is passed through untouched.
+    SourceStage* source = useWavFileParam->get() ? static_cast<SourceStage*>(&wavFileSource)
+                                                 : static_cast<SourceStage*>(&hostInputSource);
+    if (!source->isAvailable())
+        return;
     
-    if (useWavFile && audioFileBuffer.getNumSamples() > 0)
+    // ===== Sleep once the input and the effect's tail are silent =====
+    // Only the host input can fall silent; the WAV file keeps playing. The
+    // rechunker's latency is part of the tail, since its quantum still holds
+    // audio when the input stops.
+    const bool inputIsSilent = source == &hostInputSource
+                            && SilenceGate::isSilent(buffer, totalNumInputChannels);
+    silenceGate.setTailSamples(getTailSamples() + rechunker.getLatencySamples());
+    
+    switch (silenceGate.update(inputIsSilent, buffer.getNumSamples()))
     {
-        // ===== PROCESS WAV FILE =====
-        int numSamples = buffer.getNumSamples();
-        int numChannels = totalNumOutputChannels;
-        int fileChannels = audioFileBuffer.getNumChannels();
-
-        // ===== STEP 1: Read audio file data and prepare for TS9 processing =====
-        // Create a mono buffer for TS9 WASM processing
-        juce::AudioBuffer<float> ts9InputBuffer(1, numSamples);
-        float* ts9InputData = ts9InputBuffer.getWritePointer(0);
+        case SilenceGate::Decision::sleep:
+            buffer.clear();
+            return;
         
-        // Sum stereo file to mono for TS9 input
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            int pos = playbackPosition + sample;
-            if (pos >= audioFileBuffer.getNumSamples())
-                pos %= audioFileBuffer.getNumSamples(); // loop
-            
-            float sampleL = audioFileBuffer.getSample(0, pos);
-            float sampleR = fileChannels > 1 ? audioFileBuffer.getSample(1, pos) : sampleL;
-            ts9InputData[sample] = (sampleL + sampleR) * 0.5f; // Sum to mono
-        }
+        case SilenceGate::Decision::wakeAndProcess:
+            wakeFromSleep();
+            break;
         
-        // ===== STEP 2: Process through TS9 WASM =====
-        // Sync JUCE parameters to TS9 WASM
-        for (auto* param : getParameters())
-        {
-            juce::String paramName = param->getName(100);
-            
-            if (!paramName.startsWith("TS9 "))
-                continue;
-                
-            juce::String originalLabel = paramName.substring(4);
-            
-            if (ts9ParameterIndexMap.count(originalLabel) > 0)
-            {
-                int wasmIndex = ts9ParameterIndexMap[originalLabel];
-                float value = 0.0f;
-                
-                if (auto* floatParam = dynamic_cast<juce::AudioParameterFloat*>(param))
-                {
-                    juce::NormalisableRange<float> range = floatParam->getNormalisableRange();
-                    value = range.convertFrom0to1(param->getValue());
-                }
-                else if (auto* boolParam = dynamic_cast<juce::AudioParameterBool*>(param))
-                {
-                    value = boolParam->get() ? 1.0f : 0.0f;
-                }
-                
-                w2c_ts9_setParamValue(&ts9WasmApp, 0, wasmIndex, value);
-            }
-        }
+        case SilenceGate::Decision::process:
+            break;
+    }
+    
+    // The DSP always runs in quanta of `processingQuantum` samples, whatever
+    // the host's block size; the rechunker delays the output by one quantum
+    // to make that possible. Only the quanta this block completes get
+    // processed, possibly none.
+    const int numQuanta = rechunker.getNumQuantaFor(buffer.getNumSamples());
+    const int numSamplesToProcess = numQuanta * processingQuantum;
+    
+    if (numSamplesToProcess > 0)
+    {
+        // Mono downmix through one TS9, or every channel through its own
+        const int numTs9Channels = ts9PerChannelParam->get() ? totalNumOutputChannels : 1;
         
-        // Setup TS9 WASM buffers in memory
-        const u32 ts9_buffer_size = numSamples;
-        const u32 ts9_input_buffer_offset = 1024;
-        const u32 ts9_output_buffer_offset = 1024 + (ts9_buffer_size * sizeof(float));
-        const u32 ts9_input_ptrs_offset = 1024 + (ts9_buffer_size * sizeof(float) * 2);
-        const u32 ts9_output_ptrs_offset = ts9_input_ptrs_offset + sizeof(u32);
+        // The bank only runs while there are per-channel TS9 outputs, and
+        // its lines still hold whatever it heard last time, so it restarts
+        // from silence whenever it comes back into use
+        const bool useBank = numTs9Channels > 1;
+        if (useBank && !pitchBankInUse)
+            pitchShifterBank.reset();
+        pitchBankInUse = useBank;
         
-        // Write input to WASM memory
-        float* ts9_wasm_input = (float*)(ts9WasmMemory->data + ts9_input_buffer_offset);
-        for (u32 i = 0; i < ts9_buffer_size; i++)
-        {
-            ts9_wasm_input[i] = ts9InputData[i];
-        }
+        // The sandboxed module or its native translation; whichever takes
+        // over starts from cleared state
+        ts9Engine.setBackend(ts9NativeParam->get() ? Ts9Engine::Backend::native
+                                                   : Ts9Engine::Backend::wasm);
         
-        // Create input/output pointer arrays (mono processing)
-        u32* ts9_input_ptrs = (u32*)(ts9WasmMemory->data + ts9_input_ptrs_offset);
-        u32* ts9_output_ptrs = (u32*)(ts9WasmMemory->data + ts9_output_ptrs_offset);
-        ts9_input_ptrs[0] = ts9_input_buffer_offset;
-        ts9_output_ptrs[0] = ts9_output_buffer_offset;
+        // The math behind the sandboxed module's powf/tanf imports
+        ts9Engine.setMathAccuracy((WasmMath::Accuracy)ts9MathAccuracyParam->getIndex());
         
-        // Process through TS9
-        w2c_ts9_compute(&ts9WasmApp, 0, ts9_buffer_size, ts9_input_ptrs_offset, ts9_output_ptrs_offset);
+        // Parameter changes are picked up once per block and ramped across
+        // the samples it processes in ControlRamp::subBlockSize steps, so
+        // automation stays smooth however large the host block is. Unchanged
+        // parameters start no ramp, and while nothing ramps the stages run
+        // over whole quanta.
+        ts9Engine.beginBlock(numTs9Channels, numSamplesToProcess);
         
-        // Read TS9 output from WASM memory
-        float* ts9_wasm_output = (float*)(ts9WasmMemory->data + ts9_output_buffer_offset);
-        juce::AudioBuffer<float> ts9OutputBuffer(1, numSamples);
-        float* ts9OutputData = ts9OutputBuffer.getWritePointer(0);
-        for (u32 i = 0; i < ts9_buffer_size; i++)
-        {
-            float sample = ts9_wasm_output[i];
-            // Clamp to prevent explosions
-            if (!std::isfinite(sample) || sample > 10.0f || sample < -10.0f)
-                sample = 0.0f;
-            ts9OutputData[i] = sample;
-        }
+        const bool leftChanged = leftPitchRamps.setTargets(*leftShiftParam, *leftWindowParam, *leftXfadeParam, numSamplesToProcess);
+        const bool rightChanged = rightPitchRamps.setTargets(*rightShiftParam, *rightWindowParam, *rightXfadeParam, numSamplesToProcess);
         
-        // ===== STEP 3: Apply pitch shifting to TS9-processed audio =====
-        // Temporary buffers for pitch shifting
-        juce::AudioBuffer<float> tempBuffer(1, numSamples); // FAUST processes mono
+        bool harmonyChanged = false;
+        for (auto& voice : harmonyVoices)
+            harmonyChanged = voice.setTargets(numSamplesToProcess) || harmonyChanged;
         
-        for (int channel = 0; channel < numChannels; ++channel)
-        {
-            float* outputData = buffer.getWritePointer(channel);
-            
-            // Fill temp buffer with TS9-processed data (for pitch shifting)
-            // The TS9 output will be used as both the dry signal and pitch shifter input
-            float* tempData = tempBuffer.getWritePointer(0);
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                // Use TS9-processed audio as input to pitch shifter
-                tempData[sample] = ts9OutputData[sample];
-            }
-            
-            // Update pitch shifter parameters from current parameter values
-            pitchShifterLeft.fHslider1 = *leftShiftParam;    // shift (semitones)
-            pitchShifterLeft.fHslider0 = *leftWindowParam;   // window (samples)
-            pitchShifterLeft.fHslider2 = *leftXfadeParam;    // xfade (samples)
-            
-            pitchShifterRight.fHslider1 = *rightShiftParam;  // shift (semitones)
-            pitchShifterRight.fHslider0 = *rightWindowParam; // window (samples)
-            pitchShifterRight.fHslider2 = *rightXfadeParam;  // xfade (samples)
-            
-            // Apply pitch shifting to TS9-processed audio
-            float* inputOutputPtr[1] = {tempData};
-            
-            if (channel == 0) // Left channel
-            {
-                pitchShifterLeft.compute(numSamples, inputOutputPtr, inputOutputPtr);
-            }
-            else if (channel == 1) // Right channel
-            {
-                pitchShifterRight.compute(numSamples, inputOutputPtr, inputOutputPtr);
-            }
-            
-            // Mix: TS9-processed audio (dry) + pitch-shifted TS9-processed audio
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                outputData[sample] = ts9OutputData[sample] + tempData[sample];
-            }
-        }
-
-        // Advance playback position
-        playbackPosition += numSamples;
-        if (playbackPosition >= audioFileBuffer.getNumSamples())
-            playbackPosition %= audioFileBuffer.getNumSamples();
+        // A block too short to ramp over jumps straight to the new values
+        if ((leftChanged || rightChanged || harmonyChanged) && !isPitchRamping())
+            applyPitchParameters();
     }
-    else if (!useWavFile)
+    
+    SampleSanitiser::Trips blockTrips;
+    bool didResetDsp = false;
+    
+    // Every stage runs over one quantum before the next one starts, so the
+    // intermediate buffers stay in L1 between stages and the WASM buffers
+    // have a fixed size.
+    rechunker.process(buffer, [&] (juce::AudioBuffer<float>& quantum)
     {
-        // ===== PROCESS REAL AUDIO INPUT =====
-        int numSamples = buffer.getNumSamples();
-        int numChannels = totalNumOutputChannels;
+        // ===== STAGE 2: Source signal, written into WASM memory =====
+        source->render(quantum, 0, processingQuantum, ts9Engine.getInputs(), ts9Engine.getNumActive());
         
-        // ===== STEP 1: Prepare real audio input for TS9 processing =====
-        // Create a mono buffer for TS9 WASM processing from input buffer
-        juce::AudioBuffer<float> ts9InputBuffer(1, numSamples);
-        float* ts9InputData = ts9InputBuffer.getWritePointer(0);
+        // ===== STAGE 3: Process through TS9 WASM =====
+        blockTrips += processTS9(processingQuantum, didResetDsp);
         
-        // Sum input channels to mono for TS9 input
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float sum = 0.0f;
-            for (int channel = 0; channel < totalNumInputChannels; ++channel)
-            {
-                sum += buffer.getSample(channel, sample);
-            }
-            ts9InputData[sample] = sum / (float)totalNumInputChannels; // Average to mono
-        }
+        // ===== STAGE 4: Pitch shift TS9 output and mix with dry TS9 signal =====
+        processPitchShiftAndMix(quantum, 0, processingQuantum, totalNumOutputChannels,
+                                ts9Engine.getOutputs(), ts9Engine.getNumActive());
+    });
+    
+    if (numQuanta > 0)
+        ts9Sanitiser.publish(blockTrips, didResetDsp);
+}
+
+SampleSanitiser::Trips AudioPluginAudioProcessor::processTS9(int numSamples, bool& didResetDsp)
+{
+    // Process through TS9, in place in linear memory
+    ts9Engine.process(numSamples);
+    
+    // Scrub NaN/Inf/out-of-range samples to prevent explosions
+    SampleSanitiser::Trips trips;
+    
+    for (int channel = 0; channel < ts9Engine.getNumActive(); ++channel)
+    {
+        const auto channelTrips = ts9Sanitiser.process(ts9Engine.getOutput(channel), numSamples);
+        trips += channelTrips;
         
-        // ===== STEP 2: Process through TS9 WASM =====
-        // Sync JUCE parameters to TS9 WASM
-        for (auto* param : getParameters())
+        // A module that produced garbage may keep doing so from its filter
+        // state, so optionally start it over from silence
+        if (channelTrips.total() > 0 && ts9Sanitiser.getPolicy() == SampleSanitiser::Policy::resetDsp)
         {
-            juce::String paramName = param->getName(100);
-            
-            if (!paramName.startsWith("TS9 "))
-                continue;
-                
-            juce::String originalLabel = paramName.substring(4);
-            
-            if (ts9ParameterIndexMap.count(originalLabel) > 0)
-            {
-                int wasmIndex = ts9ParameterIndexMap[originalLabel];
-                float value = 0.0f;
-                
-                if (auto* floatParam = dynamic_cast<juce::AudioParameterFloat*>(param))
-                {
-                    juce::NormalisableRange<float> range = floatParam->getNormalisableRange();
-                    value = range.convertFrom0to1(param->getValue());
-                }
-                else if (auto* boolParam = dynamic_cast<juce::AudioParameterBool*>(param))
-                {
-                    value = boolParam->get() ? 1.0f : 0.0f;
-                }
-                
-                w2c_ts9_setParamValue(&ts9WasmApp, 0, wasmIndex, value);
-            }
+            ts9Engine.clear(channel);
+            didResetDsp = true;
         }
+    }
+    
+    return trips;
+}
+
+void AudioPluginAudioProcessor::processPitchShiftAndMix(juce::AudioBuffer<float>& buffer,
+                                                        int startSample,
+                                                        int numSamples,
+                                                        int numChannels,
+                                                        const float* const* ts9Outputs,
+                                                        int numTs9Outputs)
+{
+    // Per-channel TS9 outputs go through the bank, one voice per channel.
+    // Channels beyond the bank (should the host exceed the prepared layout)
+    // get the dry TS9 signal twice, as the unshifted channels used to.
+    const bool perChannel = numTs9Outputs > 1;
+    const int numVoices = perChannel ? juce::jmin(numChannels, pitchShifterBank.getNumVoices()) : 0;
+    
+    // Whole quantum at once unless a slider is ramping, then one sub-block per
+    // ramp step
+    const bool isRamping = isPitchRamping();
+    const int stepSize = isRamping ? ControlRamp::subBlockSize : numSamples;
+    
+    for (int offset = 0; offset < numSamples; offset += stepSize)
+    {
+        const int subBlockSamples = juce::jmin(stepSize, numSamples - offset);
         
-        // Setup TS9 WASM buffers in memory
-        const u32 ts9_buffer_size = numSamples;
-        const u32 ts9_input_buffer_offset = 1024;
-        const u32 ts9_output_buffer_offset = 1024 + (ts9_buffer_size * sizeof(float));
-        const u32 ts9_input_ptrs_offset = 1024 + (ts9_buffer_size * sizeof(float) * 2);
-        const u32 ts9_output_ptrs_offset = ts9_input_ptrs_offset + sizeof(u32);
-        
-        // Write input to WASM memory
-        float* ts9_wasm_input = (float*)(ts9WasmMemory->data + ts9_input_buffer_offset);
-        for (u32 i = 0; i < ts9_buffer_size; i++)
+        if (isRamping)
         {
-            ts9_wasm_input[i] = ts9InputData[i];
+            leftPitchRamps.advance();
+            rightPitchRamps.advance();
+            for (auto& voice : harmonyVoices)
+                voice.advance();
+            applyPitchParameters();
         }
         
-        // Create input/output pointer arrays (mono processing)
-        u32* ts9_input_ptrs = (u32*)(ts9WasmMemory->data + ts9_input_ptrs_offset);
-        u32* ts9_output_ptrs = (u32*)(ts9WasmMemory->data + ts9_output_ptrs_offset);
-        ts9_input_ptrs[0] = ts9_input_buffer_offset;
-        ts9_output_ptrs[0] = ts9_output_buffer_offset;
+        // A channel's TS9 output (the shared mono one, or its own in
+        // per-channel mode) is both its dry signal and its voice's input. The
+        // voices write straight into the output channels, then the dry signal
+        // is added on top.
+        auto getDryData = [&] (int channel)
+        {
+            return ts9Outputs[juce::jmin(channel, numTs9Outputs - 1)] + offset;
+        };
         
-        // Process through TS9
-        w2c_ts9_compute(&ts9WasmApp, 0, ts9_buffer_size, ts9_input_ptrs_offset, ts9_output_ptrs_offset);
+        // The harmonizer hears the mono TS9 output, or in per-channel mode
+        // the per-channel outputs mixed down to mono
+        const float* harmonizerSource = getDryData(0);
         
-        // Read TS9 output from WASM memory
-        float* ts9_wasm_output = (float*)(ts9WasmMemory->data + ts9_output_buffer_offset);
-        juce::AudioBuffer<float> ts9OutputBuffer(1, numSamples);
-        float* ts9OutputData = ts9OutputBuffer.getWritePointer(0);
-        for (u32 i = 0; i < ts9_buffer_size; i++)
+        if (perChannel)
         {
-            float sample = ts9_wasm_output[i];
-            // Clamp to prevent explosions
-            if (!std::isfinite(sample) || sample > 10.0f || sample < -10.0f)
-                sample = 0.0f;
-            ts9OutputData[i] = sample;
+            float* mono = harmonizerInput.getWritePointer(0);
+            juce::FloatVectorOperations::copy(mono, getDryData(0), subBlockSamples);
+            for (int channel = 1; channel < numTs9Outputs; ++channel)
+                juce::FloatVectorOperations::add(mono, getDryData(channel), subBlockSamples);
+            juce::FloatVectorOperations::multiply(mono, 1.0f / (float)numTs9Outputs, subBlockSamples);
+            harmonizerSource = mono;
         }
         
-        // ===== STEP 3: Apply pitch shifting to TS9-processed audio =====
-        // Temporary buffers for pitch shifting
-        juce::AudioBuffer<float> tempBuffer(1, numSamples); // FAUST processes mono
+        // Left and right are harmonizer taps unless the bank has them; a mono
+        // output has nowhere to put the right one
+        float* buses[numHarmonizerBuses] = {
+            perChannel ? nullptr : harmonizerBuses.getWritePointer(leftBus),
+            perChannel || numChannels < 2 ? nullptr : harmonizerBuses.getWritePointer(rightBus),
+            harmonizerBuses.getWritePointer(harmonyBus)
+        };
         
-        for (int channel = 0; channel < numChannels; ++channel)
+        harmonizer.process(harmonizerSource, buses, numHarmonizerBuses, subBlockSamples);
+        
+        if (numVoices > 0)
         {
-            float* outputData = buffer.getWritePointer(channel);
+            const float* voiceInputs[PitchShifterBank::maxVoices];
+            float* voiceOutputs[PitchShifterBank::maxVoices];
             
-            // Fill temp buffer with TS9-processed data (for pitch shifting)
-            float* tempData = tempBuffer.getWritePointer(0);
-            for (int sample = 0; sample < numSamples; ++sample)
+            for (int voice = 0; voice < numVoices; ++voice)
             {
-                // Use TS9-processed audio as input to pitch shifter
-                tempData[sample] = ts9OutputData[sample];
+                voiceInputs[voice] = getDryData(voice);
+                voiceOutputs[voice] = buffer.getWritePointer(voice, startSample + offset);
             }
             
-            // Update pitch shifter parameters from current parameter values
-            pitchShifterLeft.fHslider1 = *leftShiftParam;    // shift (semitones)
-            pitchShifterLeft.fHslider0 = *leftWindowParam;   // window (samples)
-            pitchShifterLeft.fHslider2 = *leftXfadeParam;    // xfade (samples)
-            
-            pitchShifterRight.fHslider1 = *rightShiftParam;  // shift (semitones)
-            pitchShifterRight.fHslider0 = *rightWindowParam; // window (samples)
-            pitchShifterRight.fHslider2 = *rightXfadeParam;  // xfade (samples)
-            
-            // Apply pitch shifting to TS9-processed audio
-            float* inputOutputPtr[1] = {tempData};
-            
-            if (channel == 0) // Left channel
-            {
-                pitchShifterLeft.compute(numSamples, inputOutputPtr, inputOutputPtr);
-            }
-            else if (channel == 1) // Right channel
-            {
-                pitchShifterRight.compute(numSamples, inputOutputPtr, inputOutputPtr);
-            }
+            pitchShifterBank.process(voiceInputs, voiceOutputs, subBlockSamples);
+        }
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* outputData = buffer.getWritePointer(channel, startSample + offset);
+            const float* dryData = getDryData(channel);
             
             // Mix: TS9-processed audio (dry) + pitch-shifted TS9-processed audio
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                outputData[sample] = ts9OutputData[sample] + tempData[sample];
-            }
+            if (!perChannel)
+                juce::FloatVectorOperations::add(outputData, buses[channel % 2], dryData, subBlockSamples);
+            else if (channel >= numVoices)
+                juce::FloatVectorOperations::add(outputData, dryData, dryData, subBlockSamples);
+            else
+                juce::FloatVectorOperations::add(outputData, dryData, subBlockSamples);
+            
+            // Harmony voices sit on every channel
+            juce::FloatVectorOperations::add(outputData, buses[harmonyBus], subBlockSamples);
         }
     }
 }
 
+void AudioPluginAudioProcessor::wakeFromSleep() noexcept
+{
+    // The gate slept once the taps of the current windows had read nothing
+    // but silence, but a window that grew while asleep reaches further back,
+    // into the audio from before. So the pitch shifter lines are cleared too;
+    // that only touches the frames written since their last clear. The TS9
+    // states are a few hundred bytes each, the rechunker holds one quantum,
+    // and the controls jump to wherever the parameters moved while asleep.
+    ts9Engine.reset();
+    rechunker.reset();
+    harmonizer.reset();
+    pitchShifterBank.reset();
+    
+    leftPitchRamps.reset(*leftShiftParam, *leftWindowParam, *leftXfadeParam);
+    rightPitchRamps.reset(*rightShiftParam, *rightWindowParam, *rightXfadeParam);
+    for (auto& voice : harmonyVoices)
+        voice.reset();
+    applyPitchParameters();
+}
+
+bool AudioPluginAudioProcessor::isPitchRamping() const noexcept
+{
+    if (leftPitchRamps.isRamping() || rightPitchRamps.isRamping())
+        return true;
+    
+    for (const auto& voice : harmonyVoices)
+        if (voice.isRamping())
+            return true;
+    
+    return false;
+}
+
+void AudioPluginAudioProcessor::applyPitchParameters() noexcept
+{
+    harmonizer.setTapParameters(leftTap,
+                                leftPitchRamps.shift.getCurrentValue(),
+                                leftPitchRamps.window.getCurrentValue(),
+                                leftPitchRamps.xfade.getCurrentValue(),
+                                1.0f);
+    harmonizer.setTapParameters(rightTap,
+                                rightPitchRamps.shift.getCurrentValue(),
+                                rightPitchRamps.window.getCurrentValue(),
+                                rightPitchRamps.xfade.getCurrentValue(),
+                                1.0f);
+    
+    for (int index = 0; index < numHarmonyVoices; ++index)
+    {
+        const auto& voice = harmonyVoices[(size_t)index];
+        harmonizer.setTapParameters(firstHarmonyTap + index,
+                                    voice.pitch.shift.getCurrentValue(),
+                                    voice.pitch.window.getCurrentValue(),
+                                    voice.pitch.xfade.getCurrentValue(),
+                                    voice.level.getCurrentValue());
+    }
+    
+    for (int voice = 0; voice < pitchShifterBank.getNumVoices(); ++voice)
+    {
+        const auto& ramps = (voice % 2 == 0) ? leftPitchRamps : rightPitchRamps;
+        pitchShifterBank.setVoiceParameters(voice,
+                                            ramps.shift.getCurrentValue(),    // shift (semitones)
+                                            ramps.window.getCurrentValue(),   // window (samples)
+                                            ramps.xfade.getCurrentValue());   // xfade (samples)
+    }
+}
+
 //==============================================================================
 bool AudioPluginAudioProcessor::hasEditor() const
 {
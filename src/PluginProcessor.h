@@ -1,9 +1,14 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
-#include "fausts/pitchShifter.cpp"
-#include "wasm-ts9.h"
-#include <map>
+#include "SourceStages.h"
+#include "Ts9Engine.h"
+#include "SampleSanitiser.h"
+#include "ControlRamp.h"
+#include "PitchShifterBank.h"
+#include "Harmonizer.h"
+#include "QuantumRechunker.h"
+#include "SilenceGate.h"
 
 //==============================================================================
 class AudioPluginAudioProcessor final : public juce::AudioProcessor
@@ -45,28 +50,157 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    /** Scrubs the TS9 output. Its policy can be changed and its trip counters
+        polled from any thread. */
+    SampleSanitiser& getTs9Sanitiser() noexcept { return ts9Sanitiser; }
+    const Ts9Engine::TrapStats& getTs9TrapStats() const noexcept { return ts9Engine.getTrapStats(); }
+
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
     
     static juce::AudioProcessor::BusesProperties createBusesProperties();
     static void createTS9ParametersAndInitWasm(juce::AudioProcessor& processor,
-                                                w2c_ts9& wasm_app,
-                                                wasm_rt_memory_t*& wasm_memory,
-                                                std::map<juce::String, int>& parameterIndexMap);
+                                                Ts9Engine& engine);
+    
+    SampleSanitiser::Trips processTS9(int numSamples, bool& didResetDsp);
+    void processPitchShiftAndMix(juce::AudioBuffer<float>& buffer,
+                                 int startSample,
+                                 int numSamples,
+                                 int numChannels,
+                                 const float* const* ts9Outputs,
+                                 int numTs9Outputs);
+    void applyPitchParameters() noexcept;
+    bool isPitchRamping() const noexcept;
+    void wakeFromSleep() noexcept;
+    int64_t getTailSamples() const;
+    
+    // Number of samples each pipeline stage processes before handing over
+    // to the next one, independent of the host block size. 128 floats =
+    // 512 bytes per buffer, comfortably L1-resident.
+    static constexpr int processingQuantum = 128;
+    static_assert(processingQuantum % ControlRamp::subBlockSize == 0,
+                  "Quanta must start on a ramp sub-block boundary");
+    
+    QuantumRechunker rechunker;
+    SilenceGate silenceGate;
+    double currentSampleRate = 48000.0;
+    
+    // Source stages
+    WavFileSource wavFileSource;
+    HostInputSource hostInputSource;
+    
+    // TS9 WASM modules
+    Ts9Engine ts9Engine;
+    SampleSanitiser ts9Sanitiser;
+    
+    // Pitch shifters. The mono TS9 output feeds one shared delay line with
+    // a read tap per voice; per-channel TS9 outputs each need their own
+    // line, so in that mode the left and right voices run in the bank
+    // instead, one per output channel. Even channels follow the left
+    // parameters, odd channels the right ones, and harmony voices go to
+    // every channel.
+    Harmonizer harmonizer;
+    PitchShifterBank pitchShifterBank;
+    bool pitchBankInUse = false;
+    
+    enum HarmonizerTap
+    {
+        leftTap,
+        rightTap,
+        firstHarmonyTap
+    };
+    
+    enum HarmonizerBus
+    {
+        leftBus,
+        rightBus,
+        harmonyBus,
+        numHarmonizerBuses
+    };
+    
+    static constexpr int numHarmonyVoices = 4;
+    static_assert(firstHarmonyTap + numHarmonyVoices <= Harmonizer::maxTaps, "Not enough harmonizer taps");
+    
+    // One quantum per bus, plus the mono mix feeding the harmonizer in
+    // per-channel mode
+    juce::AudioBuffer<float> harmonizerBuses;
+    juce::AudioBuffer<float> harmonizerInput;
+    
+    // Control-rate ramps for one parameter side's sliders
+    struct PitchShifterRamps
+    {
+        ControlRamp shift, window, xfade;
+        
+        bool isRamping() const noexcept { return shift.isRamping() || window.isRamping() || xfade.isRamping(); }
+        
+        void reset(float newShift, float newWindow, float newXfade) noexcept
+        {
+            shift.reset(newShift);
+            window.reset(newWindow);
+            xfade.reset(newXfade);
+        }
+        
+        /** Returns true if any slider moved, ramped or not. */
+        bool setTargets(float newShift, float newWindow, float newXfade, int numSamples) noexcept
+        {
+            const bool changed = newShift != shift.getTargetValue()
+                              || newWindow != window.getTargetValue()
+                              || newXfade != xfade.getTargetValue();
+            shift.setTarget(newShift, numSamples);
+            window.setTarget(newWindow, numSamples);
+            xfade.setTarget(newXfade, numSamples);
+            return changed;
+        }
+        
+        void advance() noexcept
+        {
+            shift.advance();
+            window.advance();
+            xfade.advance();
+        }
+    };
     
-    // Audio file playback
-    juce::AudioBuffer<float> audioFileBuffer;
-    int playbackPosition = 0;
+    PitchShifterRamps leftPitchRamps;
+    PitchShifterRamps rightPitchRamps;
     
-    // TS9 WASM module
-    w2c_ts9 ts9WasmApp;
-    wasm_rt_memory_t* ts9WasmMemory = nullptr;
-    std::map<juce::String, int> ts9ParameterIndexMap;
+    // An extra interval on top of the left/right shifters, off at level 0
+    struct HarmonyVoice
+    {
+        PitchShifterRamps pitch;
+        ControlRamp level;
+        
+        juce::AudioParameterFloat* shiftParam = nullptr;
+        juce::AudioParameterFloat* windowParam = nullptr;
+        juce::AudioParameterFloat* xfadeParam = nullptr;
+        juce::AudioParameterFloat* levelParam = nullptr;
+        
+        bool isRamping() const noexcept { return pitch.isRamping() || level.isRamping(); }
+        
+        void reset() noexcept
+        {
+            pitch.reset(*shiftParam, *windowParam, *xfadeParam);
+            level.reset(*levelParam);
+        }
+        
+        /** Returns true if any slider moved, ramped or not. */
+        bool setTargets(int numSamples) noexcept
+        {
+            const bool levelChanged = levelParam->get() != level.getTargetValue();
+            level.setTarget(*levelParam, numSamples);
+            const bool pitchChanged = pitch.setTargets(*shiftParam, *windowParam, *xfadeParam, numSamples);
+            return levelChanged || pitchChanged;
+        }
+        
+        void advance() noexcept
+        {
+            pitch.advance();
+            level.advance();
+        }
+    };
     
-    // Pitch shifters
-    mydsp pitchShifterLeft;
-    mydsp pitchShifterRight;
+    std::array<HarmonyVoice, numHarmonyVoices> harmonyVoices;
     
     // Parameters
     juce::AudioParameterFloat* leftShiftParam;
@@ -76,4 +210,7 @@ private:
     juce::AudioParameterFloat* leftXfadeParam;
     juce::AudioParameterFloat* rightXfadeParam;
     juce::AudioParameterBool* useWavFileParam;
+    juce::AudioParameterBool* ts9PerChannelParam;
+    juce::AudioParameterBool* ts9NativeParam;
+    juce::AudioParameterChoice* ts9MathAccuracyParam;
 };
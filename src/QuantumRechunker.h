@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <utility>
+
+//==============================================================================
+/**
+ * Runs the DSP in fixed-size quanta whatever block sizes the host sends.
+ *
+ * One buffer of `quantumSize` samples per channel serves as both input FIFO
+ * and output FIFO: each host sample is swapped with the processed sample
+ * waiting in the same slot, and when the slot position wraps the quantum is
+ * processed in place. The host hears the output exactly one quantum late,
+ * and every DSP call sees the same number of samples.
+ */
+class QuantumRechunker
+{
+public:
+    /** Allocates the quantum buffer. Not realtime safe. */
+    void prepare(int numChannels, int quantumSizeToUse)
+    {
+        quantumSize = quantumSizeToUse;
+        quantum.setSize(numChannels, quantumSize);
+        reset();
+    }
+
+    /** Drops buffered audio, e.g. when playback restarts. */
+    void reset() noexcept
+    {
+        quantum.clear();
+        position = 0;
+    }
+
+    int getQuantumSize() const noexcept { return quantumSize; }
+    int getLatencySamples() const noexcept { return quantumSize; }
+
+    /** Number of quanta that a host block of `numSamples` will complete. */
+    int getNumQuantaFor(int numSamples) const noexcept
+    {
+        return quantumSize > 0 ? (position + numSamples) / quantumSize : 0;
+    }
+
+    /** Swaps the host block through the quantum buffer, calling
+        `processQuantum(juce::AudioBuffer<float>&)` each time a quantum is
+        full. The callback processes the buffer in place. */
+    template <typename ProcessQuantum>
+    void process(juce::AudioBuffer<float>& hostBuffer, ProcessQuantum&& processQuantum)
+    {
+        const int numChannels = juce::jmin(hostBuffer.getNumChannels(), quantum.getNumChannels());
+        const int numSamples = hostBuffer.getNumSamples();
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int runLength = juce::jmin(numSamples - done, quantumSize - position);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                float* host = hostBuffer.getWritePointer(channel, done);
+                float* slot = quantum.getWritePointer(channel, position);
+
+                for (int i = 0; i < runLength; ++i)
+                    std::swap(host[i], slot[i]);
+            }
+
+            done += runLength;
+            position += runLength;
+
+            if (position == quantumSize)
+            {
+                processQuantum(quantum);
+                position = 0;
+            }
+        }
+    }
+
+private:
+    juce::AudioBuffer<float> quantum;
+    int quantumSize = 0;
+    int position = 0;
+};
@@ -0,0 +1,186 @@
+#include "SampleSanitiser.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+ #define FUZZAVER_SANITISER_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define FUZZAVER_SANITISER_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define FUZZAVER_SANITISER_NEON 1
+#endif
+
+namespace
+{
+    // Counts are accumulated as 1.0f per passing lane, which is exact far
+    // beyond any block size we will ever see (2^24 samples per lane).
+    struct Counts
+    {
+        float finite = 0.0f;
+        float inRange = 0.0f;
+    };
+
+    template <bool clip>
+    inline float scrubOne(float x, float limit, Counts& counts) noexcept
+    {
+        const float magnitude = std::fabs(x);
+        const bool finite = magnitude <= FLT_MAX;   // false for NaN and Inf
+        const bool inRange = magnitude <= limit;     // false for NaN, Inf and |x| > limit
+
+        counts.finite += finite ? 1.0f : 0.0f;
+        counts.inRange += inRange ? 1.0f : 0.0f;
+
+        if (clip)
+            return finite ? std::min(std::max(x, -limit), limit) : 0.0f;
+
+        return inRange ? x : 0.0f;
+    }
+
+    template <bool clip>
+    Counts scrub(float* samples, int numSamples, float limit) noexcept
+    {
+        Counts counts;
+        int i = 0;
+
+       #if FUZZAVER_SANITISER_AVX
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        const __m256 maxFinite = _mm256_set1_ps(FLT_MAX);
+        const __m256 high = _mm256_set1_ps(limit);
+        const __m256 low = _mm256_set1_ps(-limit);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        __m256 finiteCount = _mm256_setzero_ps();
+        __m256 inRangeCount = _mm256_setzero_ps();
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(samples + i);
+            const __m256 magnitude = _mm256_and_ps(x, absMask);
+            const __m256 finite = _mm256_cmp_ps(magnitude, maxFinite, _CMP_LE_OQ);
+            const __m256 inRange = _mm256_cmp_ps(magnitude, high, _CMP_LE_OQ);
+
+            finiteCount = _mm256_add_ps(finiteCount, _mm256_and_ps(finite, one));
+            inRangeCount = _mm256_add_ps(inRangeCount, _mm256_and_ps(inRange, one));
+
+            const __m256 y = clip ? _mm256_and_ps(_mm256_min_ps(_mm256_max_ps(x, low), high), finite)
+                                  : _mm256_and_ps(x, inRange);
+            _mm256_storeu_ps(samples + i, y);
+        }
+
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, finiteCount);
+        for (float lane : lanes) counts.finite += lane;
+        _mm256_store_ps(lanes, inRangeCount);
+        for (float lane : lanes) counts.inRange += lane;
+
+       #elif FUZZAVER_SANITISER_SSE2
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 maxFinite = _mm_set1_ps(FLT_MAX);
+        const __m128 high = _mm_set1_ps(limit);
+        const __m128 low = _mm_set1_ps(-limit);
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128 finiteCount = _mm_setzero_ps();
+        __m128 inRangeCount = _mm_setzero_ps();
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(samples + i);
+            const __m128 magnitude = _mm_and_ps(x, absMask);
+            const __m128 finite = _mm_cmple_ps(magnitude, maxFinite);
+            const __m128 inRange = _mm_cmple_ps(magnitude, high);
+
+            finiteCount = _mm_add_ps(finiteCount, _mm_and_ps(finite, one));
+            inRangeCount = _mm_add_ps(inRangeCount, _mm_and_ps(inRange, one));
+
+            const __m128 y = clip ? _mm_and_ps(_mm_min_ps(_mm_max_ps(x, low), high), finite)
+                                  : _mm_and_ps(x, inRange);
+            _mm_storeu_ps(samples + i, y);
+        }
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, finiteCount);
+        for (float lane : lanes) counts.finite += lane;
+        _mm_store_ps(lanes, inRangeCount);
+        for (float lane : lanes) counts.inRange += lane;
+
+       #elif FUZZAVER_SANITISER_NEON
+        const float32x4_t maxFinite = vdupq_n_f32(FLT_MAX);
+        const float32x4_t high = vdupq_n_f32(limit);
+        const float32x4_t low = vdupq_n_f32(-limit);
+        const uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+        float32x4_t finiteCount = vdupq_n_f32(0.0f);
+        float32x4_t inRangeCount = vdupq_n_f32(0.0f);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const float32x4_t x = vld1q_f32(samples + i);
+            const float32x4_t magnitude = vabsq_f32(x);
+            const uint32x4_t finite = vcleq_f32(magnitude, maxFinite);
+            const uint32x4_t inRange = vcleq_f32(magnitude, high);
+
+            finiteCount = vaddq_f32(finiteCount, vreinterpretq_f32_u32(vandq_u32(finite, one)));
+            inRangeCount = vaddq_f32(inRangeCount, vreinterpretq_f32_u32(vandq_u32(inRange, one)));
+
+            const uint32x4_t y = clip ? vandq_u32(vreinterpretq_u32_f32(vminq_f32(vmaxq_f32(x, low), high)), finite)
+                                      : vandq_u32(vreinterpretq_u32_f32(x), inRange);
+            vst1q_f32(samples + i, vreinterpretq_f32_u32(y));
+        }
+
+        float lanes[4];
+        vst1q_f32(lanes, finiteCount);
+        for (float lane : lanes) counts.finite += lane;
+        vst1q_f32(lanes, inRangeCount);
+        for (float lane : lanes) counts.inRange += lane;
+       #endif
+
+        for (; i < numSamples; ++i)
+            samples[i] = scrubOne<clip>(samples[i], limit, counts);
+
+        return counts;
+    }
+}
+
+//==============================================================================
+SampleSanitiser::Trips SampleSanitiser::process(float* samples, int numSamples) const noexcept
+{
+    if (numSamples <= 0)
+        return {};
+
+    const float currentLimit = getLimit();
+    const Counts counts = getPolicy() == Policy::hardClip ? scrub<true>(samples, numSamples, currentLimit)
+                                                          : scrub<false>(samples, numSamples, currentLimit);
+
+    // In-range implies finite as long as the limit itself is finite
+    const auto finite = (uint32_t)counts.finite;
+    const auto inRange = (uint32_t)counts.inRange;
+
+    Trips trips;
+    trips.nonFinite = (uint32_t)numSamples - finite;
+    trips.outOfRange = finite - std::min(inRange, finite);
+    return trips;
+}
+
+void SampleSanitiser::publish(const Trips& blockTrips, bool didResetDsp) noexcept
+{
+    stats.lastBlockNonFinite.store(blockTrips.nonFinite, std::memory_order_relaxed);
+    stats.lastBlockOutOfRange.store(blockTrips.outOfRange, std::memory_order_relaxed);
+
+    if (blockTrips.total() == 0)
+        return;
+
+    // Only the audio thread writes these, so load + store is enough
+    stats.totalNonFinite.store(stats.totalNonFinite.load(std::memory_order_relaxed) + blockTrips.nonFinite,
+                               std::memory_order_relaxed);
+    stats.totalOutOfRange.store(stats.totalOutOfRange.load(std::memory_order_relaxed) + blockTrips.outOfRange,
+                                std::memory_order_relaxed);
+    stats.blocksTripped.store(stats.blocksTripped.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+
+    if (didResetDsp)
+        stats.dspResets.store(stats.dspResets.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * Branch-free NaN/Inf/out-of-range scrub for module output.
+ *
+ * A sample trips when it is non-finite or when |x| exceeds the limit. The
+ * kernel builds a per-lane mask from one ordered compare (NaN and Inf both
+ * fail `|x| <= limit`), applies the policy with a blend and accumulates the
+ * mask lanes into the trip counters, so clean and dirty blocks cost the same.
+ * The widest of AVX, SSE2 or NEON available at compile time is used, with a
+ * scalar loop for the tail.
+ */
+class SampleSanitiser
+{
+public:
+    enum class Policy
+    {
+        zero,       // replace tripped samples with silence
+        hardClip,   // clamp out-of-range samples to +/-limit, zero non-finite ones
+        resetDsp    // zero like `zero` and ask the caller to clear the DSP state
+    };
+
+    struct Trips
+    {
+        uint32_t nonFinite = 0;
+        uint32_t outOfRange = 0;
+
+        uint32_t total() const noexcept { return nonFinite + outOfRange; }
+
+        Trips& operator+= (const Trips& other) noexcept
+        {
+            nonFinite += other.nonFinite;
+            outOfRange += other.outOfRange;
+            return *this;
+        }
+    };
+
+    /** Trip counters published by the audio thread with relaxed stores, so
+        any thread can poll them without locking. */
+    struct Stats
+    {
+        std::atomic<uint32_t> lastBlockNonFinite { 0 };
+        std::atomic<uint32_t> lastBlockOutOfRange { 0 };
+        std::atomic<uint64_t> totalNonFinite { 0 };
+        std::atomic<uint64_t> totalOutOfRange { 0 };
+        std::atomic<uint64_t> blocksTripped { 0 };
+        std::atomic<uint64_t> dspResets { 0 };
+    };
+
+    void setPolicy(Policy newPolicy) noexcept { policy.store(newPolicy, std::memory_order_relaxed); }
+    Policy getPolicy() const noexcept { return policy.load(std::memory_order_relaxed); }
+
+    void setLimit(float newLimit) noexcept { limit.store(newLimit, std::memory_order_relaxed); }
+    float getLimit() const noexcept { return limit.load(std::memory_order_relaxed); }
+
+    /** Scrubs `numSamples` samples in place and returns how many tripped. */
+    Trips process(float* samples, int numSamples) const noexcept;
+
+    /** Publishes one block's worth of trips. Audio thread only. */
+    void publish(const Trips& blockTrips, bool didResetDsp) noexcept;
+
+    const Stats& getStats() const noexcept { return stats; }
+
+private:
+    std::atomic<Policy> policy { Policy::zero };
+    std::atomic<float> limit { 10.0f };
+    Stats stats;
+};
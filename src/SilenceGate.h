@@ -0,0 +1,87 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+//==============================================================================
+/**
+ * Decides when the whole effect can stop processing.
+ *
+ * The processor reports, once per host block, whether its input was silent.
+ * Once the input has been silent for longer than the effect's tail, nothing
+ * audible can come out any more and the gate goes to sleep; the first
+ * non-silent block wakes it again, and the caller gets one chance to bring
+ * its DSP state back in line before processing resumes.
+ */
+class SilenceGate
+{
+public:
+    // -120 dBFS: far below anything the TS9 gain stages could lift to audibility
+    static constexpr float silenceThreshold = 1.0e-6f;
+
+    enum class Decision
+    {
+        process,
+        wakeAndProcess,
+        sleep
+    };
+
+    /** True if the first `numChannels` channels peak below the threshold.
+        Uses JUCE's vectorised min/max scan. */
+    static bool isSilent(const juce::AudioBuffer<float>& buffer, int numChannels) noexcept
+    {
+        const int numSamples = buffer.getNumSamples();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(channel), numSamples);
+            if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold)
+                return false;
+        }
+
+        return true;
+    }
+
+    /** Samples of silence after which the output is silent too. */
+    void setTailSamples(int64_t newTailSamples) noexcept { tailSamples = newTailSamples; }
+
+    /** Feeds one host block and says what to do with it. */
+    Decision update(bool inputIsSilent, int numSamples) noexcept
+    {
+        if (!inputIsSilent)
+        {
+            silentSamples = 0;
+
+            if (sleeping)
+            {
+                sleeping = false;
+                return Decision::wakeAndProcess;
+            }
+
+            return Decision::process;
+        }
+
+        if (!sleeping)
+        {
+            // Any block that still overlaps the tail is processed in full
+            const bool tailAlreadyOver = silentSamples >= tailSamples;
+            silentSamples += numSamples;
+            sleeping = tailAlreadyOver;
+        }
+
+        return sleeping ? Decision::sleep : Decision::process;
+    }
+
+    bool isSleeping() const noexcept { return sleeping; }
+
+    /** Forgets the silence history, e.g. after prepareToPlay. */
+    void reset() noexcept
+    {
+        silentSamples = 0;
+        sleeping = false;
+    }
+
+private:
+    int64_t tailSamples = 0;
+    int64_t silentSamples = 0;
+    bool sleeping = false;
+};
@@ -0,0 +1,119 @@
+#include "SourceStages.h"
+#include "BinaryData.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <iostream>
+
+//==============================================================================
+void WavFileSource::loadFromBinaryData(const char* resourceName)
+{
+    std::cout << "Loading audio file from binary data..." << std::endl;
+    
+    int dataSize = 0;
+    const char* data = BinaryData::getNamedResource(resourceName, dataSize);
+    
+    if (data == nullptr || dataSize <= 0)
+    {
+        std::cout << "ERROR: Binary data not found!" << std::endl;
+        return;
+    }
+    
+    std::cout << "Binary data found: " << dataSize << " bytes" << std::endl;
+    
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    
+    auto inputStream = std::make_unique<juce::MemoryInputStream>(data, dataSize, false);
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(std::move(inputStream)));
+    
+    if (reader == nullptr)
+    {
+        std::cout << "ERROR: Could not create audio reader!" << std::endl;
+        return;
+    }
+    
+    std::cout << "Audio file loaded successfully!" << std::endl;
+    std::cout << "  Sample rate: " << reader->sampleRate << std::endl;
+    std::cout << "  Num channels: " << reader->numChannels << std::endl;
+    std::cout << "  Length in samples: " << reader->lengthInSamples << std::endl;
+    std::cout << "  Duration: " << (reader->lengthInSamples / reader->sampleRate) << " seconds" << std::endl;
+    
+    audioFileBuffer.setSize(reader->numChannels, (int)reader->lengthInSamples);
+    reader->read(&audioFileBuffer, 0, (int)reader->lengthInSamples, 0, true, true);
+    
+    std::cout << "Audio file loaded into buffer" << std::endl;
+}
+
+void WavFileSource::render(const juce::AudioBuffer<float>& hostBuffer,
+                           int startSample,
+                           int numSamples,
+                           float* const* destinations,
+                           int numDestinations)
+{
+    juce::ignoreUnused(hostBuffer, startSample);
+    
+    const int fileLength = audioFileBuffer.getNumSamples();
+    const int fileChannels = audioFileBuffer.getNumChannels();
+    
+    // Copy in contiguous runs so the loop point never lands inside a vector op
+    int written = 0;
+    while (written < numSamples)
+    {
+        const int runLength = juce::jmin(numSamples - written, fileLength - playbackPosition);
+        
+        if (numDestinations == 1)
+        {
+            const float* left = audioFileBuffer.getReadPointer(0, playbackPosition);
+            const float* right = fileChannels > 1 ? audioFileBuffer.getReadPointer(1, playbackPosition) : left;
+            
+            // Sum stereo file to mono for TS9 input
+            juce::FloatVectorOperations::copyWithMultiply(destinations[0] + written, left, 0.5f, runLength);
+            juce::FloatVectorOperations::addWithMultiply(destinations[0] + written, right, 0.5f, runLength);
+        }
+        else
+        {
+            for (int channel = 0; channel < numDestinations; ++channel)
+                juce::FloatVectorOperations::copy(destinations[channel] + written,
+                                                  audioFileBuffer.getReadPointer(channel % fileChannels, playbackPosition),
+                                                  runLength);
+        }
+        
+        written += runLength;
+        playbackPosition += runLength;
+        if (playbackPosition >= fileLength)
+            playbackPosition = 0; // loop
+    }
+}
+
+//==============================================================================
+void HostInputSource::render(const juce::AudioBuffer<float>& hostBuffer,
+                             int startSample,
+                             int numSamples,
+                             float* const* destinations,
+                             int numDestinations)
+{
+    if (numInputChannels <= 0)
+    {
+        for (int channel = 0; channel < numDestinations; ++channel)
+            juce::FloatVectorOperations::clear(destinations[channel], numSamples);
+        return;
+    }
+    
+    if (numDestinations > 1)
+    {
+        // Per-channel TS9: each instance gets its own input channel
+        for (int channel = 0; channel < numDestinations; ++channel)
+            juce::FloatVectorOperations::copy(destinations[channel],
+                                              hostBuffer.getReadPointer(channel % numInputChannels, startSample),
+                                              numSamples);
+        return;
+    }
+    
+    // Average input channels to mono for TS9 input
+    float* destination = destinations[0];
+    const float gain = 1.0f / (float)numInputChannels;
+    juce::FloatVectorOperations::copyWithMultiply(destination, hostBuffer.getReadPointer(0, startSample), gain, numSamples);
+    
+    for (int channel = 1; channel < numInputChannels; ++channel)
+        juce::FloatVectorOperations::addWithMultiply(destination, hostBuffer.getReadPointer(channel, startSample), gain, numSamples);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+//==============================================================================
+/**
+ * First stage of the processing pipeline: produces the mono signal that feeds
+ * the TS9. Every stage after the source is shared, so switching between the
+ * embedded WAV file and the host input only swaps this object.
+ */
+class SourceStage
+{
+public:
+    virtual ~SourceStage() = default;
+
+    /** Returns false if the source has nothing to play (e.g. missing WAV data). */
+    virtual bool isAvailable() const = 0;
+
+    /** Writes `numSamples` samples to each of the `numDestinations` buffers.
+        With one destination the source is mixed down to mono; with several,
+        destination c gets source channel c (wrapping around if the source
+        has fewer channels). `hostBuffer` holds the host input for the samples
+        being processed; `startSample` is the offset within it. */
+    virtual void render(const juce::AudioBuffer<float>& hostBuffer,
+                        int startSample,
+                        int numSamples,
+                        float* const* destinations,
+                        int numDestinations) = 0;
+};
+
+//==============================================================================
+/** Loops the embedded guitar recording. */
+class WavFileSource final : public SourceStage
+{
+public:
+    /** Decodes a BinaryData resource. Call from the constructor, not the audio thread. */
+    void loadFromBinaryData(const char* resourceName);
+
+    bool isAvailable() const override { return audioFileBuffer.getNumSamples() > 0; }
+
+    void render(const juce::AudioBuffer<float>& hostBuffer,
+                int startSample,
+                int numSamples,
+                float* const* destinations,
+                int numDestinations) override;
+
+private:
+    juce::AudioBuffer<float> audioFileBuffer;
+    int playbackPosition = 0;
+};
+
+//==============================================================================
+/** Passes the host input through, or averages it to mono. */
+class HostInputSource final : public SourceStage
+{
+public:
+    void setNumInputChannels(int numChannels) { numInputChannels = numChannels; }
+
+    bool isAvailable() const override { return true; }
+
+    void render(const juce::AudioBuffer<float>& hostBuffer,
+                int startSample,
+                int numSamples,
+                float* const* destinations,
+                int numDestinations) override;
+
+private:
+    int numInputChannels = 0;
+};
@@ -0,0 +1,320 @@
+#include "Ts9Engine.h"
+#include "ControlRamp.h"
+#include "WasmMemoryPool.h"
+#include "WasmRuntime.h"
+#include "WasmTrap.h"
+#include "fausts/Ts9Native.h"
+
+#include <iostream>
+
+//==============================================================================
+static const FaustWasmModuleInfo& getTs9Module()
+{
+    // Registered by fuzzaver_add_faust_wasm_modules() in CMakeLists.txt
+    auto* module = FaustWasmRegistry::findModule("ts9");
+    jassert(module != nullptr);
+    return *module;
+}
+
+struct Ts9Engine::Instance
+{
+    Ts9Native native;
+    bool faulted = false;
+};
+
+// Shows which imports run per sample, per block or only at init
+static void logImportCounts(FaustWasmInstance& instance)
+{
+    const auto& env = instance.getImportEnv();
+    const uint64_t computeCalls = env.computeCalls.load(std::memory_order_relaxed);
+
+    if (computeCalls > 0)
+    {
+        std::cout << "TS9 math imports (" << instance.getMathProvider().name << ") over " << computeCalls
+                  << " compute calls, " << env.computedSamples.load(std::memory_order_relaxed) << " samples:";
+
+        for (int i = 0; i < WasmMath::numImports; ++i)
+        {
+            const auto import = (WasmMath::Import)i;
+            if (const uint64_t calls = env.getCalls(import))
+                std::cout << " " << WasmMath::getImportName(import) << " " << calls
+                          << " (" << (double)calls / (double)computeCalls << " per compute)";
+        }
+
+        std::cout << std::endl;
+    }
+
+    instance.resetImportCounts();
+}
+
+//==============================================================================
+Ts9Engine::Ts9Engine()
+{
+    // Every instance in the process borrows its linear memory from the pool
+    WasmMemoryPool::getInstance().install();
+
+    // The runtime is up (see the `runtime` member); every channel's state
+    // lives in this one instance
+    bank = std::make_unique<Ts9InstanceBank>(getTs9Module());
+    createInstance(0);
+}
+
+Ts9Engine::~Ts9Engine() = default;
+
+wasm_rt_memory_t& Ts9Engine::getPrimaryMemory() noexcept
+{
+    return bank->getMemory();
+}
+
+const FaustWasmUiDescriptor& Ts9Engine::getDescriptor() const
+{
+    return bank->getInstance().getModule().descriptor;
+}
+
+void Ts9Engine::createInstance(int channel)
+{
+    auto& instance = instances[(size_t)channel];
+    if (instance == nullptr)
+        instance = std::make_unique<Instance>();
+
+    targets[(size_t)channel] = { bank.get(), channel, &instance->native };
+}
+
+void Ts9Engine::initialisePrimary(uint32_t sampleRate)
+{
+    // After the first instance in the process at this rate, init is a copy
+    // of the DSP state it left behind. Otherwise it runs the module, which
+    // can trap like compute does.
+    {
+        const WasmTrapScope trapScope;
+
+        try
+        {
+            bank->init(getDescriptor().dspSize, sampleRate);
+        }
+        catch (const WasmTrap& trap)
+        {
+            fault(0, trap.code);
+        }
+    }
+
+    instances[0]->native.init((int)sampleRate);
+    parameterBindings.pushAll(targets.data(), 1);
+}
+
+//==============================================================================
+bool Ts9Engine::prepare(double sampleRate, int numChannels, int maxSamples, int subBlockSamples)
+{
+    WasmRuntime::ensureThreadInitialised();
+
+    if (const auto faulted = trapStats.faultedChannels.exchange(0))
+        std::cout << "TS9 instances trapped since the last prepare (mask 0x" << std::hex << faulted << std::dec
+                  << ", last: " << wasm_rt_strerror((wasm_rt_trap_t)trapStats.lastTrap.load()) << "), re-initialising" << std::endl;
+
+    numChannels = juce::jlimit(1, maxChannels, numChannels);
+
+    // Park every channel's DSP state and I/O buffers inside linear memory,
+    // above the module-owned region. The source writes straight into the
+    // input slot and the later stages read straight from the output slot.
+    // A trap in the module's init faults every state: they are all copies of
+    // the one that trapped.
+    wasm_rt_trap_t initTrap = WASM_RT_TRAP_NONE;
+    {
+        const WasmTrapScope trapScope;
+
+        try
+        {
+            numPrepared = bank->prepare(getDescriptor().dspSize, reservedBytes, (u32)sampleRate,
+                                        numChannels, (uint32_t)maxSamples, (uint32_t)subBlockSamples);
+        }
+        catch (const WasmTrap& trap)
+        {
+            numPrepared = bank->getNumStates();
+            initTrap = trap.code;
+        }
+    }
+
+    if (numPrepared < numChannels)
+        std::cout << "ERROR: Could not lay out TS9 states for channels " << numPrepared << " and up" << std::endl;
+
+    for (int channel = 0; channel < numPrepared; ++channel)
+    {
+        createInstance(channel);
+        auto& instance = *instances[(size_t)channel];
+
+        instance.native.init((int)sampleRate);
+        instance.faulted = false;
+
+        inputs[(size_t)channel] = bank->getSlots(channel).input;
+        outputs[(size_t)channel] = bank->getSlots(channel).output;
+    }
+
+    if (initTrap != WASM_RT_TRAP_NONE)
+    {
+        std::cout << "ERROR: TS9 init trapped (" << wasm_rt_strerror(initTrap) << "), bypassing it" << std::endl;
+
+        for (int channel = 0; channel < numPrepared; ++channel)
+            fault(channel, initTrap);
+    }
+
+    std::cout << "Prepared " << numPrepared << " TS9 state(s) in one WASM memory of " << bank->getMemory().size
+              << " bytes, " << bank->getBytesPerState() << " bytes of state and I/O slots each" << std::endl;
+
+    const auto pool = WasmMemoryPool::getInstance().getStats();
+    std::cout << "WASM memory pool: " << pool.numBorrowed << " borrowed, " << pool.numIdle << " idle, "
+              << (pool.reservedBytes >> 20) << " MiB reserved, " << (pool.committedBytes >> 10) << " KiB committed" << std::endl;
+
+    logImportCounts(bank->getInstance());
+
+    // Restore the parameter values the init calls just reset
+    parameterBindings.pushAll(targets.data(), numPrepared);
+    numActive = juce::jmin(numActive, juce::jmax(1, numPrepared));
+    return numPrepared > 0;
+}
+
+void Ts9Engine::beginBlock(int numChannelsToRun, int numSamples) noexcept
+{
+    numChannelsToRun = juce::jlimit(1, juce::jmax(1, numPrepared), numChannelsToRun);
+
+    for (int channel = numActive; channel < numChannelsToRun; ++channel)
+        clear(channel);
+
+    numActive = numChannelsToRun;
+
+    // Inactive instances get every push too, so their controls are current
+    // whenever they are switched back in
+    parameterBindings.beginBlock(targets.data(), numPrepared, numSamples);
+}
+
+void Ts9Engine::process(int numSamples) noexcept
+{
+    // Hosts may render each block on a different worker thread. Setting one
+    // up takes a preallocated altstack, so it doesn't allocate.
+    WasmRuntime::ensureThreadInitialised();
+    const WasmTrapScope trapScope;
+
+    if (!parameterBindings.isRamping())
+    {
+        for (int channel = 0; channel < numActive; ++channel)
+            computeInstance(channel, 0, numSamples);
+        return;
+    }
+
+    // While a parameter is ramping the quantum is computed one sub-block at a
+    // time, each through its own pre-built pointer array
+    for (int offset = 0; offset < numSamples; offset += ControlRamp::subBlockSize)
+    {
+        const int subBlockSamples = juce::jmin(ControlRamp::subBlockSize, numSamples - offset);
+        parameterBindings.advanceRamps(targets.data(), numPrepared);
+
+        for (int channel = 0; channel < numActive; ++channel)
+            computeInstance(channel, offset, subBlockSamples);
+    }
+}
+
+void Ts9Engine::computeInstance(int channel, int offset, int numSamples) noexcept
+{
+    auto& instance = *instances[(size_t)channel];
+
+    if (backend == Backend::native)
+    {
+        // The native DSP reads and writes the same slots through plain pointers
+        float* input = inputs[(size_t)channel] + offset;
+        float* output = outputs[(size_t)channel] + offset;
+        instance.native.compute(numSamples, &input, &output);
+        return;
+    }
+
+    if (instance.faulted)
+    {
+        bypass(channel, offset, numSamples);
+        return;
+    }
+
+    try
+    {
+        bank->compute(channel, (uint32_t)offset, (uint32_t)numSamples);
+    }
+    catch (const WasmTrap& trap)
+    {
+        // The output may be half written; pass the whole call's input instead
+        fault(channel, trap.code);
+        bypass(channel, offset, numSamples);
+    }
+}
+
+void Ts9Engine::fault(int channel, wasm_rt_trap_t code) noexcept
+{
+    instances[(size_t)channel]->faulted = true;
+
+    // Only the audio thread writes these, so load + store is enough
+    trapStats.traps.store(trapStats.traps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    trapStats.lastTrap.store((int)code, std::memory_order_relaxed);
+    trapStats.lastChannel.store(channel, std::memory_order_relaxed);
+    trapStats.faultedChannels.fetch_or(1u << channel, std::memory_order_relaxed);
+}
+
+void Ts9Engine::bypass(int channel, int offset, int numSamples) noexcept
+{
+    juce::FloatVectorOperations::copy(outputs[(size_t)channel] + offset, inputs[(size_t)channel] + offset, numSamples);
+}
+
+bool Ts9Engine::isFaulted(int channel) const noexcept
+{
+    return juce::isPositiveAndBelow(channel, numPrepared) && instances[(size_t)channel]->faulted;
+}
+
+void Ts9Engine::setMathAccuracy(WasmMath::Accuracy accuracy) noexcept
+{
+    bank->getInstance().setMathProvider(WasmMath::getProvider(accuracy));
+}
+
+void Ts9Engine::setBackend(Backend newBackend) noexcept
+{
+    if (newBackend == backend)
+        return;
+
+    backend = newBackend;
+
+    for (int channel = 0; channel < numPrepared; ++channel)
+        clear(channel);
+}
+
+void Ts9Engine::clear(int channel) noexcept
+{
+    if (!juce::isPositiveAndBelow(channel, numPrepared))
+        return;
+
+    auto& instance = *instances[(size_t)channel];
+
+    if (backend == Backend::native)
+    {
+        instance.native.instanceClear();
+        return;
+    }
+
+    // A faulted state stays bypassed until the next prepare re-initialises it
+    if (instance.faulted)
+        return;
+
+    // Also reached outside process(), from beginBlock and from the
+    // sanitiser's resetDsp policy, so it opens a scope of its own
+    const WasmTrapScope trapScope;
+
+    try
+    {
+        bank->instanceClear(channel);
+    }
+    catch (const WasmTrap& trap)
+    {
+        fault(channel, trap.code);
+    }
+}
+
+void Ts9Engine::reset() noexcept
+{
+    for (int channel = 0; channel < numPrepared; ++channel)
+        clear(channel);
+
+    parameterBindings.pushAll(targets.data(), numPrepared);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "FaustWasmRegistry.h"
+#include "Ts9ParameterBindings.h"
+#include "Ts9InstanceBank.h"
+#include "WasmRuntime.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+ * The TS9 WASM DSP states behind the overdrive stage.
+ *
+ * The module is the "ts9" entry of the FaustWasmRegistry, translated from
+ * TS9_OverdriveFaustGenerated.wasm at build time.
+ *
+ * The module is instantiated once, with the engine: its JSON description
+ * drives the parameter creation. Channel 0 runs the mono downmix. In
+ * per-channel mode each channel runs through a DSP state of its own, so
+ * stereo (or wider) material keeps separate filter and clipper state per
+ * channel; the states share the one instance and linear memory through a
+ * Ts9InstanceBank. Every state is driven from the one parameter set, and
+ * within a quantum their compute calls are issued back to back on the same
+ * sample grid.
+ *
+ * All states are laid out in prepare, so switching between mono and
+ * per-channel processing on the audio thread never allocates.
+ *
+ * Each channel also carries a native C++ translation of the same DSP
+ * (fausts/Ts9Native.h), bit-exact with the module on exact math (see
+ * setMathAccuracy). When the sandbox isn't
+ * needed, the native backend skips the linear memory indirection and the
+ * imported math calls; it computes straight on the same I/O slots, so the
+ * rest of the pipeline doesn't notice which one runs.
+ *
+ * A channel whose WASM state traps (see WasmTrap.h), in compute, init or
+ * instanceClear, is marked faulted and passes its input through from then
+ * on, so the overdrive drops out on that channel instead of taking the host
+ * down. The fault is published in TrapStats and cleared by the next prepare.
+ * Containment is only built where it is verified (GCC and Clang); in MSVC
+ * builds a trap aborts.
+ */
+class Ts9Engine
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    // Upper bound on how long the TS9's filters ring after the input stops.
+    // The slowest element is the DC blocker, which is down by more than
+    // 120 dB well within this time.
+    static constexpr double tailSeconds = 0.1;
+
+    enum class Backend
+    {
+        wasm,
+        native
+    };
+
+    /** Trap counters published by the audio thread with relaxed stores, so
+        any thread can poll them without locking. */
+    struct TrapStats
+    {
+        std::atomic<uint64_t> traps { 0 };
+        std::atomic<int> lastTrap { WASM_RT_TRAP_NONE };    // wasm_rt_trap_t
+        std::atomic<int> lastChannel { -1 };
+        std::atomic<uint32_t> faultedChannels { 0 };        // bit per channel
+    };
+
+    Ts9Engine();
+    ~Ts9Engine();
+
+    /** The module's linear memory, e.g. for diagnostics. */
+    wasm_rt_memory_t& getPrimaryMemory() noexcept;
+
+    /** The module's UI description: controls, their zones and the DSP size. */
+    const FaustWasmUiDescriptor& getDescriptor() const;
+
+    /** Bytes at the bottom of linear memory owned by the module (DSP state
+        and JSON); host buffers are laid out above them. */
+    void setReservedBytes(uint32_t numBytes) noexcept { reservedBytes = numBytes; }
+    uint32_t getReservedBytes() const noexcept { return reservedBytes; }
+
+    Ts9ParameterBindings& getParameterBindings() noexcept { return parameterBindings; }
+
+    /** Initialises channel 0's state and pushes the parameter values, for
+        use before the host has prepared the processor. */
+    void initialisePrimary(uint32_t sampleRate);
+
+    /** Lays out and initialises `numChannels` DSP states with I/O slots for
+        up to `maxSamples` per call. Not realtime safe. */
+    bool prepare(double sampleRate, int numChannels, int maxSamples, int subBlockSamples);
+
+    int getNumPrepared() const noexcept { return numPrepared; }
+    int getNumActive() const noexcept { return numActive; }
+
+    /** Picks up parameter changes and selects how many channels run this
+        block (1 = mono downmix). Channels that come back into use are
+        cleared so they don't replay stale state. */
+    void beginBlock(int numChannelsToRun, int numSamples) noexcept;
+
+    /** Per-channel input/output buffers inside the module's memory. */
+    float* const* getInputs() const noexcept { return inputs.data(); }
+    const float* const* getOutputs() const noexcept { return outputs.data(); }
+    float* getOutput(int channel) const noexcept { return outputs[(size_t)channel]; }
+
+    /** Computes every active channel over `numSamples`, in place. */
+    void process(int numSamples) noexcept;
+
+    /** Chooses which backend computes the channels. The one taking over
+        starts from cleared state. Realtime safe. */
+    void setBackend(Backend newBackend) noexcept;
+    Backend getBackend() const noexcept { return backend; }
+
+    /** Chooses the math behind the module's powf/tanf imports. The TS9 only
+        calls them once per compute call, for its block-rate coefficients.
+        Realtime safe. */
+    void setMathAccuracy(WasmMath::Accuracy accuracy) noexcept;
+
+    /** The module's import and compute call counts since the last prepare. */
+    const w2c_env& getImportEnv() const noexcept { return bank->getInstance().getImportEnv(); }
+
+    /** True if the channel's WASM state trapped since the last prepare.
+        Audio thread only; other threads poll getTrapStats(). */
+    bool isFaulted(int channel) const noexcept;
+    const TrapStats& getTrapStats() const noexcept { return trapStats; }
+
+    /** Clears one channel's DSP state, e.g. after it produced garbage. */
+    void clear(int channel) noexcept;
+
+    /** Clears every channel and pushes the current parameter values without
+        ramping, e.g. when processing resumes after a pause. */
+    void reset() noexcept;
+
+private:
+    struct Instance;
+
+    void createInstance(int channel);
+    void computeInstance(int channel, int offset, int numSamples) noexcept;
+    void fault(int channel, wasm_rt_trap_t code) noexcept;
+    void bypass(int channel, int offset, int numSamples) noexcept;
+
+    // Declared first: the runtime outlives the module instance
+    WasmRuntime::Reference runtime;
+
+    std::unique_ptr<Ts9InstanceBank> bank;
+    std::array<std::unique_ptr<Instance>, maxChannels> instances;
+    std::array<Ts9DspTarget, maxChannels> targets {};
+    std::array<float*, maxChannels> inputs {};
+    std::array<float*, maxChannels> outputs {};
+    int numPrepared = 0;
+    int numActive = 1;
+    uint32_t reservedBytes = 0;
+    Backend backend = Backend::wasm;
+    TrapStats trapStats;
+
+    Ts9ParameterBindings parameterBindings;
+
+    JUCE_DECLARE_NON_COPYABLE(Ts9Engine)
+};
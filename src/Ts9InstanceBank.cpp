@@ -0,0 +1,97 @@
+#include "Ts9InstanceBank.h"
+#include "FaustWasmSnapshotCache.h"
+
+#include <cstring>
+
+//==============================================================================
+Ts9InstanceBank::Ts9InstanceBank(const FaustWasmModuleInfo& module)
+    : instance(module)
+{
+}
+
+int Ts9InstanceBank::prepare(uint32_t newStateBytes, uint32_t reservedBytes, u32 sampleRate,
+                             int numStatesToPrepare, uint32_t maxSamples, uint32_t subBlockSamples)
+{
+    numStatesToPrepare = juce::jlimit(0, maxStates, numStatesToPrepare);
+    numStates = 0;
+    resident = 0;
+
+    // Each state parks right below its own slots. Parking offsets must clear
+    // the module-owned region, so it is reserved even for a lone state.
+    layout.reset(getMemory(), reservedBytes);
+
+    for (int state = 0; state < numStatesToPrepare; ++state)
+    {
+        homes[(size_t)state] = layout.allocate(newStateBytes);
+        if (homes[(size_t)state] == 0 || !slots[(size_t)state].allocate(layout, maxSamples, subBlockSamples))
+            break;
+
+        numStates = state + 1;
+    }
+
+    // Growing the memory may have moved it
+    for (int state = 0; state < numStates; ++state)
+        slots[(size_t)state].resolve(layout);
+
+    init(newStateBytes, sampleRate);
+    return numStates;
+}
+
+void Ts9InstanceBank::init(uint32_t newStateBytes, u32 sampleRate)
+{
+    stateBytes = newStateBytes;
+    resident = 0;
+
+    FaustWasmSnapshotCache::getInstance().init(instance, dsp, stateBytes, sampleRate);
+
+    auto* data = getMemory().data;
+    for (int state = 1; state < numStates; ++state)
+        std::memcpy(data + homes[(size_t)state], data, stateBytes);
+}
+
+uint32_t Ts9InstanceBank::getBytesPerState() const noexcept
+{
+    return numStates > 0 ? layout.getUsedBytes() / (uint32_t)numStates : 0;
+}
+
+//==============================================================================
+void Ts9InstanceBank::compute(int state, uint32_t sampleOffset, uint32_t numSamples)
+{
+    makeResident(state);
+
+    // Within the module, each offset has its own pre-built pointer array
+    const auto& stateSlots = slots[(size_t)state];
+    instance.compute(dsp, numSamples, stateSlots.inputPointersAt(sampleOffset), stateSlots.outputPointersAt(sampleOffset));
+}
+
+void Ts9InstanceBank::setParamValue(int state, u32 index, f32 value) noexcept
+{
+    jassert(state == resident || juce::isPositiveAndBelow(state, numStates));
+    if ((state != resident && !juce::isPositiveAndBelow(state, numStates)) || (uint64_t)index + sizeof(value) > stateBytes)
+        return;
+
+    // The store the module's setParamValue would do, without entering it
+    const uint32_t zone = state == resident ? dsp : homes[(size_t)state];
+    std::memcpy(getMemory().data + zone + index, &value, sizeof(value));
+}
+
+void Ts9InstanceBank::instanceClear(int state)
+{
+    if (state != resident && !juce::isPositiveAndBelow(state, numStates))
+        return;
+
+    makeResident(state);
+    instance.instanceClear(dsp);
+}
+
+void Ts9InstanceBank::makeResident(int state) noexcept
+{
+    jassert(state == resident || juce::isPositiveAndBelow(state, numStates));
+    if (state == resident || !juce::isPositiveAndBelow(state, numStates))
+        return;
+
+    auto* data = getMemory().data;
+    std::memcpy(data + homes[(size_t)resident], data, stateBytes);
+    std::memcpy(data, data + homes[(size_t)state], stateBytes);
+    resident = state;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "FaustWasmRegistry.h"
+#include "WasmMemoryLayout.h"
+#include <array>
+
+//==============================================================================
+/**
+ * Several TS9 DSP states sharing one module instance and its linear memory.
+ *
+ * Faust's exports take the DSP state's offset, but the TS9 module is
+ * compiled with absolute addresses and ignores it: every call works on the
+ * state at offset 0. So the bank keeps one state resident there and parks
+ * the others in linear memory above the module-owned region, next to their
+ * I/O slots. Computing a parked state first swaps it in (two copies of the
+ * descriptor's `size` bytes, no allocation), so each extra channel costs its
+ * DSP state and I/O slots rather than a whole instance and memory.
+ *
+ * Parameter writes go straight into the state's zone, resident or parked;
+ * Faust's setParamValue is a plain store of the value at `dsp + index`, so
+ * they never call into the module.
+ *
+ * With a single state nothing is ever swapped.
+ */
+class Ts9InstanceBank
+{
+public:
+    static constexpr int maxStates = 16;
+
+    // Where the module keeps the DSP state it works on
+    static constexpr u32 dsp = 0;
+
+    explicit Ts9InstanceBank(const FaustWasmModuleInfo& module);
+
+    FaustWasmInstance& getInstance() noexcept { return instance; }
+    wasm_rt_memory_t& getMemory() const noexcept { return instance.getMemory(); }
+
+    /** Lays out `numStates` parked states and their I/O slots above
+        `reservedBytes`, then initialises them all (see init). Returns how
+        many fit. Not realtime safe. */
+    int prepare(uint32_t stateBytes, uint32_t reservedBytes, u32 sampleRate,
+                int numStates, uint32_t maxSamples, uint32_t subBlockSamples);
+
+    /** Initialises every state at `sampleRate`: the resident one through the
+        snapshot cache, the parked ones as copies of it. Not realtime safe.
+        Runs the module's init on a cache miss, so like compute it can throw a
+        WasmTrap; prepare passes that on once the layout is in place. */
+    void init(uint32_t stateBytes, u32 sampleRate);
+
+    int getNumStates() const noexcept { return numStates; }
+    const WasmAudioSlots& getSlots(int state) const noexcept { return slots[(size_t)state]; }
+
+    /** Linear memory each state takes: its parked DSP state and I/O slots. */
+    uint32_t getBytesPerState() const noexcept;
+
+    /** Runs one state over its slots from `sampleOffset`. Not noexcept: with
+        trap containment a trap leaves as a WasmTrap, and only that state is
+        left in doubt. */
+    void compute(int state, uint32_t sampleOffset, uint32_t numSamples);
+
+    void setParamValue(int state, u32 index, f32 value) noexcept;
+
+    /** Runs the module's instanceClear on one state; can throw a WasmTrap. */
+    void instanceClear(int state);
+
+private:
+    void makeResident(int state) noexcept;
+
+    FaustWasmInstance instance;
+    WasmLinearAllocator layout;
+    std::array<uint32_t, maxStates> homes {};    // parking offset per state
+    std::array<WasmAudioSlots, maxStates> slots {};
+    uint32_t stateBytes = 0;
+    int numStates = 0;
+    int resident = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(Ts9InstanceBank)
+};
@@ -0,0 +1,135 @@
+#include "Ts9ParameterBindings.h"
+#include "Ts9InstanceBank.h"
+#include "fausts/Ts9Native.h"
+
+//==============================================================================
+Ts9ParameterBindings::~Ts9ParameterBindings()
+{
+    for (int i = 0; i < numBindings; ++i)
+        bindings[(size_t)i].parameter->removeListener(this);
+}
+
+void Ts9ParameterBindings::add(juce::RangedAudioParameter& parameter, u32 wasmIndex, bool isToggle)
+{
+    jassert(numBindings < maxBindings);
+    if (numBindings >= maxBindings)
+        return;
+
+    auto& binding = bindings[(size_t)numBindings++];
+    binding.parameter = &parameter;
+    binding.parameterIndex = parameter.getParameterIndex();
+    binding.wasmIndex = wasmIndex;
+    binding.range = parameter.getNormalisableRange();
+    binding.isToggle = isToggle;
+    binding.value.store(toPlainValue(binding, parameter.getValue()));
+
+    parameter.addListener(this);
+    version.fetch_add(1, std::memory_order_release);
+}
+
+void Ts9ParameterBindings::beginBlock(const Ts9DspTarget* targets, int numTargets, int numSamples)
+{
+    const auto currentVersion = version.load(std::memory_order_acquire);
+    if (currentVersion == pushedVersion)
+        return;
+
+    pushedVersion = currentVersion;
+    numRamping = 0;
+
+    for (int i = 0; i < numBindings; ++i)
+    {
+        auto& binding = bindings[(size_t)i];
+        const float value = binding.value.load(std::memory_order_relaxed);
+
+        if (binding.isToggle)
+        {
+            if (value != binding.pushedValue)
+            {
+                push(binding, value, targets, numTargets);
+                binding.pushedValue = value;
+            }
+            continue;
+        }
+
+        binding.ramp.setTarget(value, numSamples);
+
+        if (binding.ramp.isRamping())
+        {
+            ++numRamping;
+        }
+        else if (binding.ramp.getCurrentValue() != binding.pushedValue)
+        {
+            // Block too short to ramp over: setTarget jumped to the new value
+            binding.pushedValue = binding.ramp.getCurrentValue();
+            push(binding, binding.pushedValue, targets, numTargets);
+        }
+    }
+}
+
+void Ts9ParameterBindings::advanceRamps(const Ts9DspTarget* targets, int numTargets)
+{
+    int stillRamping = 0;
+
+    for (int i = 0; i < numBindings; ++i)
+    {
+        auto& binding = bindings[(size_t)i];
+        if (!binding.ramp.isRamping())
+            continue;
+
+        binding.pushedValue = binding.ramp.advance();
+        push(binding, binding.pushedValue, targets, numTargets);
+        stillRamping += binding.ramp.isRamping() ? 1 : 0;
+    }
+
+    numRamping = stillRamping;
+}
+
+void Ts9ParameterBindings::pushAll(const Ts9DspTarget* targets, int numTargets)
+{
+    pushedVersion = version.load(std::memory_order_acquire);
+    numRamping = 0;
+
+    for (int i = 0; i < numBindings; ++i)
+    {
+        auto& binding = bindings[(size_t)i];
+        binding.pushedValue = binding.value.load(std::memory_order_relaxed);
+        binding.ramp.reset(binding.pushedValue);
+        push(binding, binding.pushedValue, targets, numTargets);
+    }
+}
+
+//==============================================================================
+float Ts9ParameterBindings::toPlainValue(const Binding& binding, float normalisedValue) const noexcept
+{
+    if (binding.isToggle)
+        return normalisedValue >= 0.5f ? 1.0f : 0.0f;
+
+    return binding.range.convertFrom0to1(normalisedValue);
+}
+
+void Ts9ParameterBindings::push(const Binding& binding, float value, const Ts9DspTarget* targets, int numTargets) noexcept
+{
+    for (int i = 0; i < numTargets; ++i)
+    {
+        targets[i].bank->setParamValue(targets[i].state, binding.wasmIndex, value);
+
+        if (targets[i].native != nullptr)
+            targets[i].native->setParamValue((int)binding.wasmIndex, value);
+    }
+}
+
+void Ts9ParameterBindings::parameterValueChanged(int parameterIndex, float newValue)
+{
+    // May be called from any thread, including the audio thread
+    for (int i = 0; i < numBindings; ++i)
+    {
+        auto& binding = bindings[(size_t)i];
+
+        if (binding.parameterIndex == parameterIndex)
+        {
+            binding.value.store(toPlainValue(binding, newValue), std::memory_order_relaxed);
+            version.fetch_add(1, std::memory_order_release);
+            return;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "FaustWasmRegistry.h"
+#include "ControlRamp.h"
+#include <array>
+#include <atomic>
+
+class Ts9InstanceBank;
+class Ts9Native;
+
+//==============================================================================
+/** One TS9 DSP state: a state in the instance bank, plus the native DSP
+    standing in for it when the sandbox is bypassed. */
+struct Ts9DspTarget
+{
+    Ts9InstanceBank* bank = nullptr;
+    int state = 0;
+    Ts9Native* native = nullptr;
+};
+
+//==============================================================================
+/**
+ * Flat table mapping the TS9 plugin parameters to their WASM indices.
+ *
+ * The table is built once while the parameters are created. Each binding keeps
+ * the parameter's plain (denormalised) value in an atomic that is written by
+ * the parameter listener, and a shared version counter is bumped on every
+ * change. Syncing on the audio thread is then a version check, and when
+ * something did change, one load and compare per binding; only values that
+ * differ from what was last pushed cross into the module.
+ *
+ * Continuous values are not pushed in one step: a change starts a ControlRamp
+ * over the block, and the caller advances the ramps once per sub-block while
+ * any are active. Toggles (bypass) switch immediately.
+ *
+ * Every push goes to all given targets, so several DSP states (one per
+ * channel) follow the one parameter set. Both backends of a target get it,
+ * so either can take over at any time.
+ */
+class Ts9ParameterBindings final : private juce::AudioProcessorParameter::Listener
+{
+public:
+    static constexpr int maxBindings = 16;
+
+    Ts9ParameterBindings() = default;
+    ~Ts9ParameterBindings() override;
+
+    /** Binds a parameter that has already been added to the processor.
+        Message thread only, before processing starts. */
+    void add(juce::RangedAudioParameter& parameter, u32 wasmIndex, bool isToggle);
+
+    /** Picks up the values that changed since the last block. Toggles are
+        pushed straight away; continuous values start a ramp across the
+        `numSamples` block. Realtime safe. */
+    void beginBlock(const Ts9DspTarget* targets, int numTargets, int numSamples);
+
+    /** True while any ramp still has sub-blocks to go. */
+    bool isRamping() const noexcept { return numRamping > 0; }
+
+    /** Moves every active ramp on by one sub-block and pushes the new values. */
+    void advanceRamps(const Ts9DspTarget* targets, int numTargets);
+
+    /** Pushes every value without ramping, e.g. after the module's init reset the
+        DSP's controls. */
+    void pushAll(const Ts9DspTarget* targets, int numTargets);
+
+    int size() const noexcept { return numBindings; }
+
+private:
+    struct Binding
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        int parameterIndex = -1;
+        u32 wasmIndex = 0;
+        juce::NormalisableRange<float> range;
+        bool isToggle = false;
+        std::atomic<float> value { 0.0f }; // plain value, written by the listener
+        float pushedValue = 0.0f;          // last value sent to the module
+        ControlRamp ramp;                  // continuous values only
+    };
+
+    float toPlainValue(const Binding& binding, float normalisedValue) const noexcept;
+    static void push(const Binding& binding, float value, const Ts9DspTarget* targets, int numTargets) noexcept;
+
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+
+    std::array<Binding, maxBindings> bindings;
+    int numBindings = 0;
+
+    std::atomic<uint32_t> version { 1 };
+    uint32_t pushedVersion = 0;
+    int numRamping = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(Ts9ParameterBindings)
+};
@@ -1,56 +1,64 @@
-#include "wasm-ts9.h"
-#include <cmath>
+#include "FaustWasmRegistry.h"
+#include "WasmMath.h"
 
 /**
  * Implementation of WASM environment functions
  * These are imported by the WebAssembly module for math operations
+ * Every registered Faust module links against the same set; each call runs
+ * on its instance's math provider and is counted there (see WasmMath.h)
  */
 
+static const WasmMathProvider& use(w2c_env* env, WasmMath::Import import) noexcept
+{
+    // Instances made outside FaustWasmInstance have no env
+    if (env == nullptr)
+        return WasmMath::getProvider(WasmMath::getDefaultAccuracy());
+
+    return env->use(import);
+}
+
+extern "C" {
+
 // Implement powf for WASM module
 f32 w2c_env_0x5Fpowf(struct w2c_env* env, f32 base, f32 exponent)
 {
-    (void)env; // Unused parameter
-    return std::powf(base, exponent);
+    return use(env, WasmMath::Import::pow).pow(base, exponent);
 }
 
 // Implement expf for WASM module
 f32 w2c_env_0x5Fexpf(struct w2c_env* env, f32 x)
 {
-    (void)env; // Unused parameter
-    return std::expf(x);
+    return use(env, WasmMath::Import::exp).exp(x);
 }
 
 // Implement fmodf for WASM module
 f32 w2c_env_0x5Ffmodf(struct w2c_env* env, f32 x, f32 y)
 {
-    (void)env; // Unused parameter
-    return std::fmodf(x, y);
+    return use(env, WasmMath::Import::fmod).fmod(x, y);
 }
 
 // Implement tanf for WASM module
 f32 w2c_env_0x5Ftanf(struct w2c_env* env, f32 angle)
 {
-    (void)env; // Unused parameter
-    return std::tanf(angle);
+    return use(env, WasmMath::Import::tan).tan(angle);
 }
 
 // Implement cosf for WASM module
 f32 w2c_env_0x5Fcosf(struct w2c_env* env, f32 angle)
 {
-    (void)env; // Unused parameter
-    return std::cosf(angle);
+    return use(env, WasmMath::Import::cos).cos(angle);
 }
 
 // Implement sinf for WASM module
 f32 w2c_env_0x5Fsinf(struct w2c_env* env, f32 angle)
 {
-    (void)env; // Unused parameter
-    return std::sinf(angle);
+    return use(env, WasmMath::Import::sin).sin(angle);
 }
 
 // Implement roundf for WASM module
 f32 w2c_env_0x5Froundf(struct w2c_env* env, f32 x)
 {
-    (void)env; // Unused parameter
-    return std::roundf(x);
+    return use(env, WasmMath::Import::round).round(x);
 }
+
+} // extern "C"
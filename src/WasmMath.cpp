@@ -0,0 +1,330 @@
+#include "WasmMath.h"
+
+#include <cmath>
+#include <cstring>
+
+#ifndef FUZZAVER_WASM_MATH_DEFAULT
+ #define FUZZAVER_WASM_MATH_DEFAULT exact
+#endif
+
+//==============================================================================
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+    constexpr float twoOverPi = 0.636619772367581f;
+    constexpr float ln2 = 0.693147180559945f;
+    constexpr float log2e = 1.44269504088896f;
+
+    // pi/2 in three parts, so the quadrant reduction stays exact for
+    // arguments up to reductionLimit
+    constexpr float halfPi1 = 1.5703125f;
+    constexpr float halfPi2 = 4.83751296997070e-4f;
+    constexpr float halfPi3 = 7.54978995489189e-8f;
+    constexpr float reductionLimit = 8192.0f;
+
+    float bitsToFloat(uint32_t bits) noexcept
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint32_t floatToBits(float value) noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // 2^n for the normal exponent range
+    float scaleByPowerOfTwo(float x, int n) noexcept
+    {
+        return x * bitsToFloat((uint32_t)(n + 127) << 23);
+    }
+
+    // Without SSE4.1 std::floor is a library call; this is a compare
+    int floorToInt(float x) noexcept
+    {
+        const int i = (int)x;
+        return x < (float)i ? i - 1 : i;
+    }
+
+    int floorToInt(double x) noexcept
+    {
+        const int i = (int)x;
+        return x < (double)i ? i - 1 : i;
+    }
+
+    //==============================================================================
+    float exactPow(float base, float exponent)  { return std::pow(base, exponent); }
+    float exactExp(float x)                     { return std::exp(x); }
+    float exactFmod(float x, float y)           { return std::fmod(x, y); }
+    float exactTan(float angle)                 { return std::tan(angle); }
+    float exactCos(float angle)                 { return std::cos(angle); }
+    float exactSin(float angle)                 { return std::sin(angle); }
+    float exactRound(float x)                   { return std::round(x); }
+
+    //==============================================================================
+    // e^r for |r| <= ln2 / 2
+    float polyExpReduced(float r) noexcept
+    {
+        return 1.0f + r * (1.0f + r * (0.5f + r * (1.0f / 6.0f + r * (1.0f / 24.0f
+                     + r * (1.0f / 120.0f + r * (1.0f / 720.0f))))));
+    }
+
+    // 2^t for |t| < 126. t comes in double: in float, rounding its integer
+    // part away would cost up to 2^-17 of relative accuracy.
+    float polyExp2(double t) noexcept
+    {
+        const int n = floorToInt(t + 0.5);
+        return scaleByPowerOfTwo(polyExpReduced((float)(t - (double)n) * ln2), n);
+    }
+
+    // log2(x) for normal positive x: exponent plus an atanh series for the
+    // mantissa, taken into [sqrt(1/2), sqrt(2))
+    float polyLog2(float x) noexcept
+    {
+        const uint32_t bits = floatToBits(x);
+        int e = (int)(bits >> 23) - 127;
+        float m = bitsToFloat((bits & 0x007fffffu) | 0x3f800000u);
+
+        if (m > 1.41421356f)
+        {
+            m *= 0.5f;
+            ++e;
+        }
+
+        const float f = (m - 1.0f) / (m + 1.0f);
+        const float f2 = f * f;
+        const float lnm = 2.0f * f * (1.0f + f2 * (1.0f / 3.0f + f2 * (1.0f / 5.0f + f2 * (1.0f / 7.0f + f2 * (1.0f / 9.0f)))));
+        return (float)e + lnm * log2e;
+    }
+
+    float polyPow(float base, float exponent)
+    {
+        // Positive normal bases only; zero, negative, non-finite and huge
+        // results keep libm's special cases
+        if (!(base >= 1.17549435e-38f && base < 3.4e38f) || !std::isfinite(exponent))
+            return std::pow(base, exponent);
+
+        const double t = (double)exponent * polyLog2(base);
+        return std::abs(t) < 126.0 ? polyExp2(t) : std::pow(base, exponent);
+    }
+
+    float polyExp(float x)
+    {
+        if (!(std::abs(x) < 87.0f))
+            return std::exp(x);
+
+        // ln2 in two parts, so x - n ln2 is exact rather than rounded x log2e
+        const int n = floorToInt(x * log2e + 0.5f);
+        const float r = (x - (float)n * 0.693359375f) + (float)n * 2.12194440e-4f;
+        return scaleByPowerOfTwo(polyExpReduced(r), n);
+    }
+
+    // sin and cos of r in [-pi/4, pi/4]
+    float polySinReduced(float r) noexcept
+    {
+        const float r2 = r * r;
+        return r * (1.0f - r2 * (1.0f / 6.0f - r2 * (1.0f / 120.0f - r2 * (1.0f / 5040.0f - r2 * (1.0f / 362880.0f)))));
+    }
+
+    float polyCosReduced(float r) noexcept
+    {
+        const float r2 = r * r;
+        return 1.0f - r2 * (0.5f - r2 * (1.0f / 24.0f - r2 * (1.0f / 720.0f - r2 * (1.0f / 40320.0f - r2 * (1.0f / 3628800.0f)))));
+    }
+
+    // angle = quadrant * pi/2 + r
+    int reduceQuadrant(float angle, float& r) noexcept
+    {
+        const int quadrant = floorToInt(angle * twoOverPi + 0.5f);
+        const float k = (float)quadrant;
+        r = ((angle - k * halfPi1) - k * halfPi2) - k * halfPi3;
+        return quadrant & 3;
+    }
+
+    float polySin(float angle)
+    {
+        if (!(std::abs(angle) < reductionLimit))
+            return std::sin(angle);
+
+        float r;
+        switch (reduceQuadrant(angle, r))
+        {
+            case 0:  return polySinReduced(r);
+            case 1:  return polyCosReduced(r);
+            case 2:  return -polySinReduced(r);
+            default: return -polyCosReduced(r);
+        }
+    }
+
+    float polyCos(float angle)
+    {
+        if (!(std::abs(angle) < reductionLimit))
+            return std::cos(angle);
+
+        float r;
+        switch (reduceQuadrant(angle, r))
+        {
+            case 0:  return polyCosReduced(r);
+            case 1:  return -polySinReduced(r);
+            case 2:  return -polyCosReduced(r);
+            default: return polySinReduced(r);
+        }
+    }
+
+    float polyTan(float angle)
+    {
+        if (!(std::abs(angle) < reductionLimit))
+            return std::tan(angle);
+
+        float r;
+        const int quadrant = reduceQuadrant(angle, r);
+        const float s = polySinReduced(r);
+        const float c = polyCosReduced(r);
+        return (quadrant & 1) == 0 ? s / c : -c / s;
+    }
+
+    //==============================================================================
+    // Built at static initialisation, so no call ever fills them in. Each
+    // table has a copy of its last entry appended: a position that rounds up
+    // to the end of the table then interpolates with a weight of 0.
+    struct Tables
+    {
+        static constexpr int sineSize = 4096;       // one period
+        static constexpr int exp2Size = 1024;       // 2^f, f in [0, 1]
+        static constexpr int log2Size = 1024;       // log2(m), m in [1, 2]
+
+        float sine[sineSize + 2];
+        float exp2[exp2Size + 2];
+        float log2[log2Size + 2];
+
+        Tables()
+        {
+            for (int i = 0; i <= sineSize; ++i)
+                sine[i] = (float)std::sin(2.0 * pi * i / sineSize);
+
+            for (int i = 0; i <= exp2Size; ++i)
+                exp2[i] = (float)std::exp2((double)i / exp2Size);
+
+            for (int i = 0; i <= log2Size; ++i)
+                log2[i] = (float)std::log2(1.0 + (double)i / log2Size);
+
+            sine[sineSize + 1] = sine[sineSize];
+            exp2[exp2Size + 1] = exp2[exp2Size];
+            log2[log2Size + 1] = log2[log2Size];
+        }
+    };
+
+    const Tables tables;
+
+    float lerp(const float* table, float position) noexcept
+    {
+        const int i = (int)position;
+        const float frac = position - (float)i;
+        return table[i] + frac * (table[i + 1] - table[i]);
+    }
+
+    // sin at `phase` periods. The phase is wrapped in double, so large
+    // angles keep their fraction.
+    float tableSineAtPhase(double phase) noexcept
+    {
+        const float wrapped = (float)(phase - (double)floorToInt(phase));
+        return lerp(tables.sine, wrapped * (float)Tables::sineSize);
+    }
+
+    // 2^t for |t| < 126, t in double as for polyExp2
+    float tableExp2(double t) noexcept
+    {
+        const int n = floorToInt(t);
+        return scaleByPowerOfTwo(lerp(tables.exp2, (float)(t - (double)n) * (float)Tables::exp2Size), n);
+    }
+
+    float tableLog2(float x) noexcept
+    {
+        const uint32_t bits = floatToBits(x);
+        const int e = (int)(bits >> 23) - 127;
+        const float m = bitsToFloat((bits & 0x007fffffu) | 0x3f800000u);
+        return (float)e + lerp(tables.log2, (m - 1.0f) * (float)Tables::log2Size);
+    }
+
+    float tablePow(float base, float exponent)
+    {
+        if (!(base >= 1.17549435e-38f && base < 3.4e38f) || !std::isfinite(exponent))
+            return std::pow(base, exponent);
+
+        const double t = (double)exponent * tableLog2(base);
+        return std::abs(t) < 126.0 ? tableExp2(t) : std::pow(base, exponent);
+    }
+
+    float tableExp(float x)
+    {
+        return std::abs(x) < 87.0f ? tableExp2((double)x * log2e) : std::exp(x);
+    }
+
+    float tableSin(float angle)
+    {
+        if (!(std::abs(angle) < reductionLimit))
+            return std::sin(angle);
+
+        return tableSineAtPhase(angle * (0.5 / pi));
+    }
+
+    float tableCos(float angle)
+    {
+        if (!(std::abs(angle) < reductionLimit))
+            return std::cos(angle);
+
+        return tableSineAtPhase(angle * (0.5 / pi) + 0.25);
+    }
+
+    float tableTan(float angle)
+    {
+        if (!(std::abs(angle) < reductionLimit))
+            return std::tan(angle);
+
+        const double phase = angle * (0.5 / pi);
+        return tableSineAtPhase(phase) / tableSineAtPhase(phase + 0.25);
+    }
+
+    //==============================================================================
+    const WasmMathProvider exactProvider { "exact", exactPow, exactExp, exactFmod, exactTan, exactCos, exactSin, exactRound };
+    const WasmMathProvider polynomialProvider { "polynomial", polyPow, polyExp, exactFmod, polyTan, polyCos, polySin, exactRound };
+    const WasmMathProvider tableProvider { "table", tablePow, tableExp, exactFmod, tableTan, tableCos, tableSin, exactRound };
+}
+
+//==============================================================================
+const WasmMathProvider& WasmMath::getProvider(Accuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case Accuracy::polynomial:  return polynomialProvider;
+        case Accuracy::table:       return tableProvider;
+        case Accuracy::exact:       break;
+    }
+
+    return exactProvider;
+}
+
+WasmMath::Accuracy WasmMath::getDefaultAccuracy() noexcept
+{
+    // Set from FUZZAVER_WASM_MATH in CMakeLists.txt
+    return Accuracy::FUZZAVER_WASM_MATH_DEFAULT;
+}
+
+const char* WasmMath::getImportName(Import import) noexcept
+{
+    switch (import)
+    {
+        case Import::pow:   return "_powf";
+        case Import::exp:   return "_expf";
+        case Import::fmod:  return "_fmodf";
+        case Import::tan:   return "_tanf";
+        case Import::cos:   return "_cosf";
+        case Import::sin:   return "_sinf";
+        case Import::round: return "_roundf";
+    }
+
+    return "";
+}
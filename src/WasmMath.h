@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * One implementation of the math a Faust WASM module imports from "env".
+ *
+ * Faust modules only import single-precision libm functions (the ones
+ * WasmEnv.cpp exports). fmod and round are always exact: they are cheap
+ * already, and approximating them would change results rather than
+ * precision.
+ */
+struct WasmMathProvider
+{
+    const char* name;
+    float (*pow)(float base, float exponent);
+    float (*exp)(float x);
+    float (*fmod)(float x, float y);
+    float (*tan)(float angle);
+    float (*cos)(float angle);
+    float (*sin)(float angle);
+    float (*round)(float x);
+};
+
+namespace WasmMath
+{
+    enum class Accuracy
+    {
+        exact,          // libm
+        polynomial,     // range reduction plus short polynomials, 1e-7 to 1e-6 relative
+        table           // linearly interpolated tables, ~1e-6; tan loses precision near its poles
+    };
+
+    enum class Import
+    {
+        pow,
+        exp,
+        fmod,
+        tan,
+        cos,
+        sin,
+        round
+    };
+
+    constexpr int numImports = 7;
+
+    const WasmMathProvider& getProvider(Accuracy accuracy) noexcept;
+
+    /** The accuracy new instances start with, FUZZAVER_WASM_MATH at
+        configure time. */
+    Accuracy getDefaultAccuracy() noexcept;
+
+    /** The import's name in the module, e.g. "_powf". */
+    const char* getImportName(Import import) noexcept;
+}
+
+//==============================================================================
+/**
+ * The import instance wasm2c passes to every "env" function.
+ *
+ * Each FaustWasmInstance owns one, so every instance can pick its own math
+ * provider and counts its own import calls. Next to the per-import counts it
+ * counts compute calls and samples, which tells the imports that run per
+ * sample apart from the ones that run per block or only at init.
+ *
+ * Only the thread running the instance writes the counters, with relaxed
+ * load + store, so any thread can poll them without locking.
+ */
+struct w2c_env
+{
+    std::atomic<const WasmMathProvider*> math { &WasmMath::getProvider(WasmMath::getDefaultAccuracy()) };
+
+    std::array<std::atomic<uint64_t>, WasmMath::numImports> calls {};
+    std::atomic<uint64_t> computeCalls { 0 };
+    std::atomic<uint64_t> computedSamples { 0 };
+
+    const WasmMathProvider& use(WasmMath::Import import) noexcept
+    {
+        add(calls[(size_t)import], 1);
+        return *math.load(std::memory_order_relaxed);
+    }
+
+    void countCompute(uint64_t numSamples) noexcept
+    {
+        add(computeCalls, 1);
+        add(computedSamples, numSamples);
+    }
+
+    uint64_t getCalls(WasmMath::Import import) const noexcept
+    {
+        return calls[(size_t)import].load(std::memory_order_relaxed);
+    }
+
+    void resetCounts() noexcept
+    {
+        for (auto& count : calls)
+            count.store(0, std::memory_order_relaxed);
+
+        computeCalls.store(0, std::memory_order_relaxed);
+        computedSamples.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static void add(std::atomic<uint64_t>& counter, uint64_t amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,96 @@
+#include "WasmMemoryLayout.h"
+
+#include <iostream>
+
+// Must match the page size wasm-rt allocates with
+static constexpr uint64_t wasmPageSize = 65536;
+
+//==============================================================================
+void WasmLinearAllocator::reset(wasm_rt_memory_t& memoryToUse, uint32_t reservedBytes)
+{
+    memory = &memoryToUse;
+    reservedEnd = reservedBytes;
+    top = reservedBytes;
+}
+
+uint32_t WasmLinearAllocator::allocate(uint32_t numBytes, uint32_t alignment)
+{
+    if (memory == nullptr || alignment == 0 || (alignment & (alignment - 1)) != 0)
+        return 0;
+
+    const uint64_t start = ((uint64_t)top + alignment - 1) & ~(uint64_t)(alignment - 1);
+    const uint64_t end = start + numBytes;
+
+    if (end > UINT32_MAX || !ensureSize(end))
+    {
+        std::cout << "ERROR: WASM memory layout does not fit (" << end << " bytes requested, "
+                  << memory->size << " available)" << std::endl;
+        return 0;
+    }
+
+    top = (uint32_t)end;
+    return (uint32_t)start;
+}
+
+bool WasmLinearAllocator::contains(uint32_t offset, uint32_t numBytes) const noexcept
+{
+    return memory != nullptr && (uint64_t)offset + numBytes <= memory->size;
+}
+
+bool WasmLinearAllocator::ensureSize(uint64_t requiredBytes)
+{
+    if (requiredBytes <= memory->size)
+        return true;
+
+    const uint64_t missingPages = (requiredBytes - memory->size + wasmPageSize - 1) / wasmPageSize;
+    if (memory->pages + missingPages > memory->max_pages)
+        return false;
+
+    return wasm_rt_grow_memory(memory, missingPages) != (uint64_t)-1;
+}
+
+//==============================================================================
+bool WasmAudioSlots::allocate(WasmLinearAllocator& allocator, uint32_t maxSamples, uint32_t subBlockSamples)
+{
+    *this = {};
+
+    if (maxSamples == 0)
+        return false;
+
+    const uint32_t step = (subBlockSamples == 0 || subBlockSamples > maxSamples) ? maxSamples : subBlockSamples;
+    const uint32_t numEntries = (maxSamples + step - 1) / step;
+
+    // Buffers on cache-line boundaries so host-side SIMD loops stay aligned
+    const uint32_t in = allocator.allocate(maxSamples * (uint32_t)sizeof(float), 64);
+    const uint32_t out = allocator.allocate(maxSamples * (uint32_t)sizeof(float), 64);
+    const uint32_t inPtrs = allocator.allocate(numEntries * (uint32_t)sizeof(uint32_t), 4);
+    const uint32_t outPtrs = allocator.allocate(numEntries * (uint32_t)sizeof(uint32_t), 4);
+
+    if (in == 0 || out == 0 || inPtrs == 0 || outPtrs == 0)
+        return false;
+
+    capacity = maxSamples;
+    granularity = step;
+    inputBuffer = in;
+    outputBuffer = out;
+    inputPointers = inPtrs;
+    outputPointers = outPtrs;
+
+    resolve(allocator);
+
+    // Mono processing: one channel pointer per entry, fixed for the lifetime of the layout
+    for (uint32_t k = 0; k < numEntries; ++k)
+    {
+        const uint32_t byteOffset = k * step * (uint32_t)sizeof(float);
+        allocator.getPointer<uint32_t>(inputPointers)[k] = inputBuffer + byteOffset;
+        allocator.getPointer<uint32_t>(outputPointers)[k] = outputBuffer + byteOffset;
+    }
+
+    return true;
+}
+
+void WasmAudioSlots::resolve(const WasmLinearAllocator& allocator)
+{
+    input = allocator.getPointer<float>(inputBuffer);
+    output = allocator.getPointer<float>(outputBuffer);
+}
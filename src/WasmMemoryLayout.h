@@ -0,0 +1,88 @@
+#pragma once
+
+#include "wasm-rt.h"
+#include <cstdint>
+
+//==============================================================================
+/**
+ * Bump allocator for the host-managed part of a module's linear memory.
+ *
+ * Everything below `reservedBytes` belongs to the module: the Faust DSP state
+ * lives at offset 0 (its parameter zones sit inside it) and, until init runs,
+ * the JSON description occupies the same area. Blocks handed out above that
+ * line are aligned and bounds-checked against the memory size; if the memory
+ * is too small it is grown within the module's declared maximum.
+ *
+ * Allocate only at prepare time. Growing a malloc-backed memory may move
+ * `memory.data`, so resolve host pointers after the last allocation.
+ */
+class WasmLinearAllocator
+{
+public:
+    /** Starts a fresh layout directly above the module-owned region. */
+    void reset(wasm_rt_memory_t& memoryToUse, uint32_t reservedBytes);
+
+    /** Returns the offset of a new block, or 0 if it does not fit. Offset 0
+        is always module-owned, so it never denotes a valid allocation. */
+    uint32_t allocate(uint32_t numBytes, uint32_t alignment = 16);
+
+    /** True if [offset, offset + numBytes) lies inside the memory. */
+    bool contains(uint32_t offset, uint32_t numBytes) const noexcept;
+
+    template <typename T>
+    T* getPointer(uint32_t offset) const noexcept
+    {
+        return reinterpret_cast<T*>(memory->data + offset);
+    }
+
+    uint32_t getReservedBytes() const noexcept { return reservedEnd; }
+    uint32_t getUsedBytes() const noexcept { return top - reservedEnd; }
+
+private:
+    bool ensureSize(uint64_t requiredBytes);
+
+    wasm_rt_memory_t* memory = nullptr;
+    uint32_t reservedEnd = 0;
+    uint32_t top = 0;
+};
+
+//==============================================================================
+/**
+ * Mono input/output buffers plus the pointer arrays a Faust `compute` call
+ * expects, all inside linear memory. Stages read and write the host pointers
+ * directly, so no samples are copied in or out of the module.
+ */
+struct WasmAudioSlots
+{
+    uint32_t capacity = 0;        // samples per buffer
+    uint32_t granularity = 0;     // samples between sub-block entry points
+    uint32_t inputBuffer = 0;     // float[capacity]
+    uint32_t outputBuffer = 0;    // float[capacity]
+    uint32_t inputPointers = 0;   // u32[capacity / granularity], entry k -> inputBuffer + k * granularity
+    uint32_t outputPointers = 0;  // u32[capacity / granularity], entry k -> outputBuffer + k * granularity
+
+    float* input = nullptr;       // host view of inputBuffer
+    float* output = nullptr;      // host view of outputBuffer
+
+    /** Lays out the slots for up to `maxSamples` per call, with compute entry
+        points every `subBlockSamples` (0 = whole buffer only). Returns false
+        (and leaves the slots empty) if the memory cannot hold them. */
+    bool allocate(WasmLinearAllocator& allocator, uint32_t maxSamples, uint32_t subBlockSamples = 0);
+
+    /** Re-resolves the host views, e.g. after the memory was grown. */
+    void resolve(const WasmLinearAllocator& allocator);
+
+    /** `ins`/`outs` arguments for a compute call starting `sampleOffset`
+        samples into the buffers. The offset must be a multiple of the
+        granularity. Each entry is a one-channel pointer array of its own,
+        so no pointers are rewritten on the audio thread. */
+    uint32_t inputPointersAt(uint32_t sampleOffset) const noexcept
+    {
+        return inputPointers + (sampleOffset / granularity) * (uint32_t)sizeof(uint32_t);
+    }
+
+    uint32_t outputPointersAt(uint32_t sampleOffset) const noexcept
+    {
+        return outputPointers + (sampleOffset / granularity) * (uint32_t)sizeof(uint32_t);
+    }
+};
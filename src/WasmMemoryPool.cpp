@@ -0,0 +1,256 @@
+#include "WasmMemoryPool.h"
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+ #include <windows.h>
+#else
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+WasmMemoryPool& WasmMemoryPool::getInstance()
+{
+    static WasmMemoryPool pool;
+    return pool;
+}
+
+WasmMemoryPool::~WasmMemoryPool()
+{
+    // Blocks are plain reservations of the size the runtime asks for, so
+    // memories freed after this go back to the OS without noticing
+    if (installed)
+        wasm_rt_set_memory_source(nullptr);
+
+    for (auto& block : idle)
+        destroyBlock(block);
+}
+
+void WasmMemoryPool::install()
+{
+    std::lock_guard<std::mutex> guard (lock);
+    if (installed)
+        return;
+
+    wasm_rt_memory_source_t source;
+    source.reserve = [](uint64_t reserveBytes, uint64_t commitBytes, void* pool)
+    {
+        return static_cast<WasmMemoryPool*>(pool)->borrow(reserveBytes, commitBytes);
+    };
+    source.release = [](void* data, uint64_t reserveBytes, uint64_t usedBytes, void* pool)
+    {
+        static_cast<WasmMemoryPool*>(pool)->giveBack(data, reserveBytes, usedBytes);
+    };
+    source.user_data = this;
+
+    wasm_rt_set_memory_source(&source);
+    installed = true;
+}
+
+WasmMemoryPool::Stats WasmMemoryPool::getStats() const
+{
+    std::lock_guard<std::mutex> guard (lock);
+
+    Stats stats;
+    stats.numBorrowed = (int)borrowed.size();
+    stats.numIdle = (int)idle.size();
+    stats.numOsReservations = numOsReservations;
+
+    for (auto* blocks : { &borrowed, &idle })
+    {
+        for (auto& block : *blocks)
+        {
+            stats.reservedBytes += block.reserveBytes;
+            stats.committedBytes += block.committedBytes;
+        }
+    }
+
+    return stats;
+}
+
+//==============================================================================
+void* WasmMemoryPool::borrow(uint64_t reserveBytes, uint64_t commitBytes)
+{
+    std::lock_guard<std::mutex> guard (lock);
+
+    // Prefer a block that already has the pages committed
+    auto best = idle.end();
+    for (auto it = idle.begin(); it != idle.end(); ++it)
+        if (it->reserveBytes == reserveBytes && (best == idle.end() || it->committedBytes > best->committedBytes))
+            best = it;
+
+    Block block;
+
+    if (best != idle.end())
+    {
+        block = *best;
+        idle.erase(best);
+
+        decommitAbove(block, commitBytes);
+        if (!commit(block, commitBytes))
+        {
+            destroyBlock(block);
+            return nullptr;
+        }
+    }
+    else
+    {
+        if (!createBlock(block, reserveBytes, commitBytes))
+            return nullptr;
+
+        ++numOsReservations;
+    }
+
+    borrowed.push_back(block);
+    return block.data;
+}
+
+void WasmMemoryPool::giveBack(void* data, uint64_t reserveBytes, uint64_t usedBytes)
+{
+    std::lock_guard<std::mutex> guard (lock);
+
+    auto it = std::find_if(borrowed.begin(), borrowed.end(),
+                           [&](const Block& b) { return b.data == data; });
+    jassert(it != borrowed.end() && it->reserveBytes == reserveBytes);
+    if (it == borrowed.end())
+        return;
+
+    Block block = *it;
+    borrowed.erase(it);
+
+    // The memory may have grown since it was borrowed
+    block.committedBytes = std::max(block.committedBytes, usedBytes);
+
+    if ((int)idle.size() >= maxIdleBlocks)
+    {
+        destroyBlock(block);
+        return;
+    }
+
+    // Hand out only zeroed pages: clear what is kept, drop the rest
+    decommitAbove(block, maxRetainedBytes);
+    std::memset(block.data, 0, (size_t)std::min(block.committedBytes, usedBytes));
+    idle.push_back(block);
+}
+
+//==============================================================================
+#ifdef _WIN32
+
+bool WasmMemoryPool::createBlock(Block& block, uint64_t reserveBytes, uint64_t commitBytes)
+{
+    block.data = static_cast<uint8_t*>(VirtualAlloc(nullptr, (SIZE_T)reserveBytes, MEM_RESERVE, PAGE_NOACCESS));
+    block.reserveBytes = reserveBytes;
+    block.committedBytes = 0;
+
+    if (block.data == nullptr)
+        return false;
+
+    if (!commit(block, commitBytes))
+    {
+        destroyBlock(block);
+        return false;
+    }
+
+    return true;
+}
+
+bool WasmMemoryPool::commit(Block& block, uint64_t commitBytes)
+{
+    if (commitBytes <= block.committedBytes)
+        return true;
+
+    if (VirtualAlloc(block.data + block.committedBytes, (SIZE_T)(commitBytes - block.committedBytes),
+                     MEM_COMMIT, PAGE_READWRITE) == nullptr)
+        return false;
+
+    block.committedBytes = commitBytes;
+    return true;
+}
+
+void WasmMemoryPool::decommitAbove(Block& block, uint64_t commitBytes)
+{
+    if (block.committedBytes <= commitBytes)
+        return;
+
+    // Decommitted pages come back zeroed
+    VirtualFree(block.data + commitBytes, (SIZE_T)(block.committedBytes - commitBytes), MEM_DECOMMIT);
+    block.committedBytes = commitBytes;
+}
+
+void WasmMemoryPool::destroyBlock(Block& block)
+{
+    VirtualFree(block.data, 0, MEM_RELEASE);
+    block = {};
+}
+
+#else
+
+bool WasmMemoryPool::createBlock(Block& block, uint64_t reserveBytes, uint64_t commitBytes)
+{
+    void* data = mmap(nullptr, (size_t)reserveBytes, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    block.data = data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+    block.reserveBytes = reserveBytes;
+    block.committedBytes = 0;
+
+    if (block.data == nullptr)
+        return false;
+
+    if (!commit(block, commitBytes))
+    {
+        destroyBlock(block);
+        return false;
+    }
+
+    return true;
+}
+
+bool WasmMemoryPool::commit(Block& block, uint64_t commitBytes)
+{
+    if (commitBytes <= block.committedBytes)
+        return true;
+
+    uint8_t* start = block.data + block.committedBytes;
+    const size_t numBytes = (size_t)(commitBytes - block.committedBytes);
+
+    if (mprotect(start, numBytes, PROT_READ | PROT_WRITE) != 0)
+        return false;
+
+    // Fault the pages in now rather than on the module's first touch
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < numBytes; offset += pageSize)
+        start[offset] = 0;
+
+    block.committedBytes = commitBytes;
+    return true;
+}
+
+void WasmMemoryPool::decommitAbove(Block& block, uint64_t commitBytes)
+{
+    if (block.committedBytes <= commitBytes)
+        return;
+
+    // A fresh mapping over the range drops the pages, and they read back as
+    // zero once committed again. madvise(MADV_DONTNEED) only promises that on
+    // Linux; on macOS the old contents can survive it.
+    uint8_t* start = block.data + commitBytes;
+    const size_t numBytes = (size_t)(block.committedBytes - commitBytes);
+
+    if (mmap(start, numBytes, PROT_NONE, MAP_FIXED | MAP_ANONYMOUS | MAP_PRIVATE, -1, 0) == MAP_FAILED)
+    {
+        std::memset(start, 0, numBytes);
+        mprotect(start, numBytes, PROT_NONE);
+    }
+
+    block.committedBytes = commitBytes;
+}
+
+void WasmMemoryPool::destroyBlock(Block& block)
+{
+    munmap(block.data, (size_t)block.reserveBytes);
+    block = {};
+}
+
+#endif
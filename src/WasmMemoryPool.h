@@ -0,0 +1,79 @@
+#pragma once
+
+#include "wasm-rt.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+/**
+ * Process-wide pool of reserved, committed WASM linear memories.
+ *
+ * Once installed as the runtime's memory source, every module instantiation
+ * in the process borrows its memory from here and hands it back when freed.
+ * A returned block keeps its mapping and up to `maxRetainedBytes` of
+ * committed, zeroed pages, so the next instantiation of the same module
+ * costs a lookup instead of an mmap/mprotect pair. The address space and
+ * resident memory in use follow the number of live instances (plus at most
+ * `maxIdleBlocks` idle ones), not the history of every instance created.
+ *
+ * Blocks are keyed by reservation size: the module's declared max_pages in
+ * the bounded-memory build (FUZZAVER_WASM_BOUNDED_MEMORY), otherwise the
+ * runtime's fixed guard-page reservation. Pages committed beyond what a
+ * borrower asks for are decommitted before it gets the block, so a memory
+ * never has more accessible pages than the runtime gave it.
+ *
+ * All of this runs wherever modules are instantiated and freed (prepare,
+ * construction), never on the audio thread.
+ */
+class WasmMemoryPool
+{
+public:
+    // Idle blocks beyond this are unmapped when returned
+    static constexpr int maxIdleBlocks = 64;
+
+    // Committed bytes an idle block keeps; anything above is decommitted
+    static constexpr uint64_t maxRetainedBytes = 1u << 20;
+
+    struct Stats
+    {
+        int numBorrowed = 0;
+        int numIdle = 0;
+        uint64_t reservedBytes = 0;    // address space held, borrowed and idle
+        uint64_t committedBytes = 0;   // accessible pages; growth shows once returned
+        int numOsReservations = 0;     // blocks ever mapped from the OS
+    };
+
+    static WasmMemoryPool& getInstance();
+
+    /** Makes the pool the runtime's memory source. Call before the first
+        module is instantiated; later calls do nothing. */
+    void install();
+
+    Stats getStats() const;
+
+private:
+    struct Block
+    {
+        uint8_t* data = nullptr;
+        uint64_t reserveBytes = 0;
+        uint64_t committedBytes = 0;
+    };
+
+    WasmMemoryPool() = default;
+    ~WasmMemoryPool();
+
+    void* borrow(uint64_t reserveBytes, uint64_t commitBytes);
+    void giveBack(void* data, uint64_t reserveBytes, uint64_t usedBytes);
+
+    static bool createBlock(Block& block, uint64_t reserveBytes, uint64_t commitBytes);
+    static bool commit(Block& block, uint64_t commitBytes);
+    static void decommitAbove(Block& block, uint64_t commitBytes);
+    static void destroyBlock(Block& block);
+
+    mutable std::mutex lock;
+    std::vector<Block> idle;
+    std::vector<Block> borrowed;
+    int numOsReservations = 0;
+    bool installed = false;
+};
@@ -0,0 +1,169 @@
+#include "WasmRuntime.h"
+#include "wasm-rt.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#if WASM_RT_STACK_EXHAUSTION_HANDLER
+ #include <pthread.h>
+#endif
+
+//==============================================================================
+namespace
+{
+    std::mutex runtimeLock;
+    int numReferences = 0;
+
+   #if WASM_RT_STACK_EXHAUSTION_HANDLER
+    // The alternate signal stacks of the threads that run modules, allocated
+    // together by the first Reference. A thread takes one with an atomic
+    // flag, so setting up a host's render thread on its first block neither
+    // allocates nor locks. The pool is never freed: a thread keeps its stack
+    // until it exits, which may be after the last Reference is gone.
+    //
+    // Which stack a thread holds is kept under a pthread key rather than in
+    // a thread_local with a destructor, whose registration allocates on the
+    // thread's first use. The key's destructor hands the stack back when the
+    // thread exits.
+    class AltStackPool
+    {
+    public:
+        static constexpr int numStacks = 64;
+
+        static AltStackPool& getInstance()
+        {
+            static auto* pool = new AltStackPool();
+            return *pool;
+        }
+
+        /** Not realtime safe; the first Reference calls it. */
+        void allocate()
+        {
+            if (isReady())
+                return;
+
+            pthread_key_create(&threadKey, threadExited);
+
+            stride = (wasm_rt_alt_stack_size() + 63) & ~(size_t)63;
+            storage.reset(new uint8_t[stride * numStacks]);    // untouched pages stay uncommitted
+            ready.store(true, std::memory_order_release);
+        }
+
+        bool isReady() const noexcept { return ready.load(std::memory_order_acquire); }
+
+        bool isThreadInitialised() const noexcept { return pthread_getspecific(threadKey) != nullptr; }
+
+        /** Sets up the calling thread with a stack from the pool. With every
+            one taken the thread runs without: faults in linear memory still
+            trap, but a stack overflow in a module can't be caught. */
+        void initialiseThread() noexcept
+        {
+            for (int index = 0; index < numStacks; ++index)
+            {
+                bool expected = false;
+                if (inUse[index].compare_exchange_strong(expected, true, std::memory_order_acquire))
+                {
+                    wasm_rt_init_thread_with_alt_stack(storage.get() + stride * (size_t)index);
+                    pthread_setspecific(threadKey, encode(index));
+                    return;
+                }
+            }
+
+            pthread_setspecific(threadKey, encode(noStack));
+        }
+
+        /** For the thread whose state wasm_rt_free() just freed. */
+        void forgetThread() noexcept
+        {
+            release(pthread_getspecific(threadKey));
+            pthread_setspecific(threadKey, nullptr);
+        }
+
+    private:
+        static constexpr int noStack = -1;
+
+        AltStackPool() = default;
+
+        // Never null, so a set key means the thread is set up
+        static void* encode(int index) noexcept { return reinterpret_cast<void*>((intptr_t)index + 2); }
+        static int decode(void* value) noexcept { return (int)(reinterpret_cast<intptr_t>(value) - 2); }
+
+        static void threadExited(void* value)
+        {
+            wasm_rt_free_thread();
+            getInstance().release(value);
+        }
+
+        void release(void* value) noexcept
+        {
+            if (value != nullptr && decode(value) != noStack)
+                inUse[decode(value)].store(false, std::memory_order_release);
+        }
+
+        pthread_key_t threadKey {};
+        std::unique_ptr<uint8_t[]> storage;
+        size_t stride = 0;
+        std::atomic<bool> inUse[numStacks] {};
+        std::atomic<bool> ready { false };
+    };
+   #endif
+}
+
+//==============================================================================
+WasmRuntime::Reference::Reference()
+{
+    std::lock_guard<std::mutex> guard (runtimeLock);
+
+    if (numReferences++ == 0)
+    {
+       #if WASM_RT_STACK_EXHAUSTION_HANDLER
+        AltStackPool::getInstance().allocate();
+       #endif
+
+        // Sets up this thread, then installs the signal handlers. wasm_rt_init
+        // only sets up the thread itself if the pool had no stack left.
+        ensureThreadInitialised();
+        wasm_rt_init();
+    }
+    else
+    {
+        ensureThreadInitialised();
+    }
+}
+
+WasmRuntime::Reference::~Reference()
+{
+    std::lock_guard<std::mutex> guard (runtimeLock);
+
+    if (--numReferences == 0)
+    {
+        // Removes the signal handlers and this thread's state. Other threads
+        // free theirs when they exit. wasm_rt_free expects this thread to have
+        // a stack, so one that got none (or never ran a module) allocates one
+        // first; off the audio thread, that is fine.
+        wasm_rt_init_thread();
+        wasm_rt_free();
+
+       #if WASM_RT_STACK_EXHAUSTION_HANDLER
+        AltStackPool::getInstance().forgetThread();
+       #endif
+    }
+}
+
+void WasmRuntime::ensureThreadInitialised() noexcept
+{
+   #if WASM_RT_STACK_EXHAUSTION_HANDLER
+    auto& altStacks = AltStackPool::getInstance();
+
+    if (altStacks.isReady() && !altStacks.isThreadInitialised())
+        altStacks.initialiseThread();
+   #endif
+}
+
+int WasmRuntime::getNumReferences() noexcept
+{
+    std::lock_guard<std::mutex> guard (runtimeLock);
+    return numReferences;
+}
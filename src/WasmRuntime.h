@@ -0,0 +1,41 @@
+#pragma once
+
+//==============================================================================
+/**
+ * Process-wide, reference-counted ownership of the wasm2c runtime.
+ *
+ * wasm_rt_init() installs the process's fault signal handlers and sets up the
+ * calling thread; wasm_rt_free() undoes both, putting back whatever SIGSEGV
+ * and SIGBUS handlers the host had installed before. Several plugin
+ * instances share one runtime, so the first Reference initialises it and the
+ * last one frees it, under a lock.
+ *
+ * The per-thread part (the altstack that lets guard page faults on a thread
+ * be handled even when its stack overflowed) is set up lazily by
+ * ensureThreadInitialised() on whatever thread first runs a module, such as
+ * each of a host's render workers, and torn down when that thread exits.
+ * The altstacks come from a pool the first Reference allocates, so that
+ * setup is realtime safe: an atomic flag per stack and one sigaltstack call.
+ * After the first call on a thread it is a per-thread key lookup, so
+ * instances rendering in parallel never contend.
+ */
+class WasmRuntime
+{
+public:
+    class Reference
+    {
+    public:
+        Reference();
+        ~Reference();
+
+    private:
+        Reference(const Reference&) = delete;
+        Reference& operator=(const Reference&) = delete;
+    };
+
+    /** Sets up the calling thread's runtime state if it isn't yet, with an
+        altstack from the pool. Never allocates. */
+    static void ensureThreadInitialised() noexcept;
+
+    static int getNumReferences() noexcept;
+};
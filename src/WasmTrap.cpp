@@ -0,0 +1,36 @@
+#include "WasmTrap.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef _WIN32
+ #include <signal.h>
+#endif
+
+thread_local int WasmTrapScope::depth = 0;
+
+//==============================================================================
+extern "C" [[noreturn]] void fuzzaver_wasm_trap(wasm_rt_trap_t code)
+{
+    if (!WasmTrapScope::isActive())
+    {
+        std::fprintf(stderr, "Uncontained WASM trap: %s\n", wasm_rt_strerror(code));
+        std::abort();
+    }
+
+   #ifndef _WIN32
+    // Guard page faults arrive inside the runtime's signal handler. Leaving it
+    // by unwinding skips the mask restore a normal return would do, so
+    // unblock the fault signals now or the next fault kills the process.
+    if (code == WASM_RT_TRAP_OOB || code == WASM_RT_TRAP_EXHAUSTION)
+    {
+        sigset_t faultSignals;
+        sigemptyset(&faultSignals);
+        sigaddset(&faultSignals, SIGSEGV);
+        sigaddset(&faultSignals, SIGBUS);
+        pthread_sigmask(SIG_UNBLOCK, &faultSignals, nullptr);
+    }
+   #endif
+
+    throw WasmTrap { code };
+}
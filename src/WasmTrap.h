@@ -0,0 +1,40 @@
+#pragma once
+
+#include "wasm-rt.h"
+
+//==============================================================================
+/**
+ * Trap containment for wasm2c code called from the audio thread.
+ *
+ * With FUZZAVER_WASM_TRAP_CONTAINMENT (GCC and Clang builds; see
+ * tests/WasmTrapTest.cpp) the runtime is built with
+ * WASM_RT_TRAP_HANDLER=fuzzaver_wasm_trap, so a trap (an explicit one, or a
+ * guard page fault the runtime's signal handler turns into one) throws a
+ * WasmTrap instead of longjmp-ing to a jmp_buf nobody set. Callers catch it
+ * around the module call. Exceptions unwind from tables, so the path that
+ * doesn't trap pays no setjmp per call; the only runtime cost is the
+ * WasmTrapScope's thread-local counter, once per block.
+ *
+ * A trap outside any WasmTrapScope has nobody to catch it and aborts, as it
+ * would have without containment.
+ */
+struct WasmTrap
+{
+    wasm_rt_trap_t code;
+};
+
+/** Marks the current thread as ready to catch WasmTraps. */
+class WasmTrapScope
+{
+public:
+    WasmTrapScope() noexcept { ++depth; }
+    ~WasmTrapScope() noexcept { --depth; }
+
+    static bool isActive() noexcept { return depth > 0; }
+
+private:
+    static thread_local int depth;
+
+    WasmTrapScope(const WasmTrapScope&) = delete;
+    WasmTrapScope& operator=(const WasmTrapScope&) = delete;
+};
@@ -0,0 +1,186 @@
+/* ------------------------------------------------------------
+Hand-optimised version of pitchShifter.cpp (Faust 2.83.6 output).
+Same interface, controls and delay geometry as the generated mydsp,
+so it can replace it anywhere a dsp is expected.
+------------------------------------------------------------ */
+
+#include "dsp.h"
+
+#ifndef  __FastPitchShifter_H__
+#define  __FastPitchShifter_H__
+
+#ifndef FAUSTFLOAT
+#define FAUSTFLOAT float
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../PitchShifterKernel.h"
+
+#if defined(_WIN32)
+#define RESTRICT __restrict
+#else
+#define RESTRICT __restrict__
+#endif
+
+/**
+ * Strength-reduced pitchShifter kernel.
+ *
+ * The loop is PitchShifterKernel::step, the one the plugin's pitch shifter
+ * bank and harmonizer run, wrapped in mydsp's interface so it can be checked
+ * against the generated code: see PitchShifterKernel.h for the reductions.
+ * Within the fast path the phasor is bit-identical to mydsp, but the output
+ * only matches it to float rounding, as the compiler may contract the two
+ * differently into FMAs.
+ *
+ * The request's incremental crossfade ramp was deliberately not done: the
+ * phasor's real step is quantised by the window's magnitude, so a ramp built
+ * from the nominal step drifts from mydsp by percents within a window. The
+ * crossfade stays one multiply per sample.
+ */
+class FastPitchShifter : public dsp {
+
+ public:
+
+	int IOTA0;
+	float fVec0[131072];
+	FAUSTFLOAT fHslider0;	// window (samples)
+	FAUSTFLOAT fHslider1;	// shift (semitones)
+	float fRec0[2];
+	FAUSTFLOAT fHslider2;	// xfade (samples)
+	int fSampleRate;
+
+ public:
+	FastPitchShifter() {
+	}
+
+	FastPitchShifter(const FastPitchShifter&) = default;
+
+	virtual ~FastPitchShifter() = default;
+
+	FastPitchShifter& operator=(const FastPitchShifter&) = default;
+
+	void metadata(Meta* m) {
+		m->declare("author", "Grame");
+		m->declare("copyright", "(c)GRAME 2006");
+		m->declare("filename", "pitchShifter.dsp");
+		m->declare("license", "BSD");
+		m->declare("name", "pitchShifter");
+		m->declare("version", "1.0");
+	}
+
+	virtual int getNumInputs() {
+		return 1;
+	}
+	virtual int getNumOutputs() {
+		return 1;
+	}
+
+	static void classInit(int sample_rate) {
+	}
+
+	virtual void instanceConstants(int sample_rate) {
+		fSampleRate = sample_rate;
+	}
+
+	virtual void instanceResetUserInterface() {
+		fHslider0 = static_cast<FAUSTFLOAT>(1e+03f);
+		fHslider1 = static_cast<FAUSTFLOAT>(0.0f);
+		fHslider2 = static_cast<FAUSTFLOAT>(1e+01f);
+	}
+
+	virtual void instanceClear() {
+		IOTA0 = 0;
+		std::fill(fVec0, fVec0 + 131072, 0.0f);
+		fRec0[0] = 0.0f;
+		fRec0[1] = 0.0f;
+	}
+
+	virtual void init(int sample_rate) {
+		classInit(sample_rate);
+		instanceInit(sample_rate);
+	}
+
+	virtual void instanceInit(int sample_rate) {
+		instanceConstants(sample_rate);
+		instanceResetUserInterface();
+		instanceClear();
+	}
+
+	virtual FastPitchShifter* clone() {
+		return new FastPitchShifter(*this);
+	}
+
+	virtual int getSampleRate() {
+		return fSampleRate;
+	}
+
+	virtual void buildUserInterface(UI* ui_interface) {
+		ui_interface->openVerticalBox("Pitch Shifter");
+		ui_interface->addHorizontalSlider("shift (semitones)", &fHslider1, FAUSTFLOAT(0.0f), FAUSTFLOAT(-12.0f), FAUSTFLOAT(12.0f), FAUSTFLOAT(0.1f));
+		ui_interface->addHorizontalSlider("window (samples)", &fHslider0, FAUSTFLOAT(1e+03f), FAUSTFLOAT(5e+01f), FAUSTFLOAT(1e+04f), FAUSTFLOAT(1.0f));
+		ui_interface->addHorizontalSlider("xfade (samples)", &fHslider2, FAUSTFLOAT(1e+01f), FAUSTFLOAT(1.0f), FAUSTFLOAT(1e+04f), FAUSTFLOAT(1.0f));
+		ui_interface->closeBox();
+	}
+
+	virtual void compute(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
+		FAUSTFLOAT* input0 = inputs[0];
+		FAUSTFLOAT* output0 = outputs[0];
+		float fSlow0 = static_cast<float>(fHslider0);
+		float fSlow1 = std::pow(2.0f, 0.083333336f * static_cast<float>(fHslider1));
+		float fSlow2 = 1.0f / static_cast<float>(fHslider2);
+
+		// Outside the range where the reductions hold (taps that could hit
+		// the clamp, a degenerate window, or a phase left above a window that
+		// just shrank), run the generated loop
+		if (!(fSlow0 >= 1.0f && 2.0f * fSlow0 <= 65537.0f && fRec0[1] < fSlow0)) {
+			computeReference(count, input0, output0, fSlow0, fSlow1, fSlow2);
+			return;
+		}
+
+		float rec = fRec0[1];
+		int iota = IOTA0;
+
+		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
+			fVec0[iota & 131071] = static_cast<float>(input0[i0]);
+
+			// The taps stay below 2w + 1, within the clamp range here
+			auto readTaps = [this, iota](int delayA, int delayB, PitchShifterKernel::Taps<float>& taps) {
+				taps = { fVec0[(iota - delayA) & 131071], fVec0[(iota - (delayA + 1)) & 131071],
+				         fVec0[(iota - delayB) & 131071], fVec0[(iota - (delayB + 1)) & 131071] };
+			};
+
+			output0[i0] = static_cast<FAUSTFLOAT>(PitchShifterKernel::step(rec, fSlow0, fSlow1, fSlow2, readTaps));
+			iota = iota + 1;
+		}
+
+		IOTA0 = iota;
+		fRec0[0] = rec;
+		fRec0[1] = rec;
+	}
+
+ private:
+	// The generated mydsp::compute loop, verbatim
+	void computeReference(int count, FAUSTFLOAT* RESTRICT input0, FAUSTFLOAT* RESTRICT output0, float fSlow0, float fSlow1, float fSlow2) {
+		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
+			float fTemp0 = static_cast<float>(input0[i0]);
+			fVec0[IOTA0 & 131071] = fTemp0;
+			fRec0[0] = std::fmod(fSlow0 + (fRec0[1] + 1.0f - fSlow1), fSlow0);
+			int iTemp1 = static_cast<int>(fRec0[0]);
+			float fTemp2 = std::floor(fRec0[0]);
+			float fTemp3 = 1.0f - fRec0[0];
+			float fTemp4 = std::min<float>(fSlow2 * fRec0[0], 1.0f);
+			float fTemp5 = fSlow0 + fRec0[0];
+			int iTemp6 = static_cast<int>(fTemp5);
+			float fTemp7 = std::floor(fTemp5);
+			output0[i0] = static_cast<FAUSTFLOAT>((fVec0[(IOTA0 - std::min<int>(65537, std::max<int>(0, iTemp1))) & 131071] * (fTemp2 + fTemp3) + (fRec0[0] - fTemp2) * fVec0[(IOTA0 - std::min<int>(65537, std::max<int>(0, iTemp1 + 1))) & 131071]) * fTemp4 + (fVec0[(IOTA0 - std::min<int>(65537, std::max<int>(0, iTemp6))) & 131071] * (fTemp7 + fTemp3 - fSlow0) + (fSlow0 + (fRec0[0] - fTemp7)) * fVec0[(IOTA0 - std::min<int>(65537, std::max<int>(0, iTemp6 + 1))) & 131071]) * (1.0f - fTemp4));
+			IOTA0 = IOTA0 + 1;
+			fRec0[1] = fRec0[0];
+		}
+	}
+
+};
+
+#endif
@@ -0,0 +1,256 @@
+/* ------------------------------------------------------------
+author: "Guitarix project (http://guitarix.sourceforge.net/)"
+copyright: "Guitarix project"
+license: "LGPL"
+name: "TS9_OverdriveFaustGenerated"
+version: "0.29"
+Native C++ translation of TS9_OverdriveFaustGenerated.wasm
+(Faust 2.28.6, -lang wasm-ib -scal -ftz 2), operation for operation.
+------------------------------------------------------------ */
+
+#include "dsp.h"
+
+#ifndef  __Ts9Native_H__
+#define  __Ts9Native_H__
+
+#ifndef FAUSTFLOAT
+#define FAUSTFLOAT float
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_WIN32)
+#define RESTRICT __restrict
+#else
+#define RESTRICT __restrict__
+#endif
+
+/**
+ * The TS9 overdrive without the WASM sandbox.
+ *
+ * Same state, constants, expression order and -ftz 2 denormal flushing as
+ * the module's compute, so the two agree to the last bit given the same
+ * powf/tanf. Controls are addressed by the module's JSON indices through
+ * setParamValue()/getParamValue(), which keeps the ts9_* parameter bindings
+ * backend-agnostic.
+ */
+class Ts9Native : public dsp {
+
+ public:
+
+	// Offsets of the controls in the WASM module's DSP state (its JSON "index")
+	static constexpr int bypassIndex = 412;
+	static constexpr int toneIndex = 428;
+	static constexpr int driveIndex = 456;
+	static constexpr int levelIndex = 484;
+
+ private:
+
+	// Clipper transfer curve, 100 points plus one zero so the interpolation's
+	// second read stays in bounds (the module reads past its table there,
+	// always with a weight of 0)
+	static constexpr float ftbl0[101] = {
+		0.0f, -0.0296990145f, -0.0599780679f, -0.0908231661f, -0.122163236f,
+		-0.15376009f, -0.184938014f, -0.214177266f, -0.239335433f, -0.259232581f,
+		-0.274433911f, -0.286183298f, -0.295538545f, -0.303222328f, -0.309706241f,
+		-0.315301329f, -0.320218444f, -0.324604988f, -0.328567117f, -0.332183361f,
+		-0.335513115f, -0.338602364f, -0.341487259f, -0.344196707f, -0.346754223f,
+		-0.349179149f, -0.351487488f, -0.35369277f, -0.35580641f, -0.357838273f,
+		-0.359796762f, -0.36168924f, -0.363522142f, -0.365301102f, -0.367031157f,
+		-0.368716747f, -0.370361924f, -0.371970236f, -0.373544991f, -0.375089139f,
+		-0.376605392f, -0.378096253f, -0.379564017f, -0.38101083f, -0.38243863f,
+		-0.383849323f, -0.385244638f, -0.386626214f, -0.38799566f, -0.389354438f,
+		-0.390703976f, -0.392045677f, -0.393380851f, -0.394710839f, -0.396036893f,
+		-0.397360265f, -0.398682207f, -0.40000397f, -0.401326776f, -0.402651846f,
+		-0.403980494f, -0.405313969f, -0.406653613f, -0.408000737f, -0.409356743f,
+		-0.41072312f, -0.412101358f, -0.413493067f, -0.414899886f, -0.416323662f,
+		-0.417766303f, -0.419229805f, -0.420716405f, -0.422228485f, -0.42376864f,
+		-0.425339758f, -0.426944911f, -0.428587586f, -0.430271626f, -0.432001382f,
+		-0.433781654f, -0.435617924f, -0.437516481f, -0.439484537f, -0.441530377f,
+		-0.443663776f, -0.445896149f, -0.448241174f, -0.450715303f, -0.453338623f,
+		-0.456136048f, -0.45913893f, -0.462387681f, -0.465935349f, -0.469853997f,
+		-0.474244624f, -0.479255259f, -0.485115886f, -0.492212713f, -0.501272738f,
+		0.0f
+	};
+
+	int fSampleRate;
+	float fConst0;
+	float fConst1;
+	FAUSTFLOAT fCheckbox0;	// bypass
+	float fRec0[2];
+	float fConst2;
+	FAUSTFLOAT fVslider0;	// tone
+	float fVec0[2];
+	float fConst3;
+	float fConst4;
+	float fConst5;
+	float fConst6;
+	FAUSTFLOAT fVslider1;	// drive
+	float fRec2[2];
+	float fRec1[2];
+	float fRec3[2];
+	FAUSTFLOAT fVslider2;	// level
+	float fRec4[2];
+
+	// -ftz 2: anything without exponent bits becomes 0
+	static float flushDenormal(float value) {
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return (bits & 2139095040u) ? value : 0.0f;
+	}
+
+ public:
+
+	Ts9Native() {
+	}
+
+	void metadata(Meta* m) {
+		m->declare("author", "Guitarix project (http://guitarix.sourceforge.net/)");
+		m->declare("copyright", "Guitarix project");
+		m->declare("filename", "TS9_OverdriveFaustGenerated.dsp");
+		m->declare("license", "LGPL");
+		m->declare("name", "TS9_OverdriveFaustGenerated");
+		m->declare("version", "0.29");
+	}
+
+	virtual int getNumInputs() {
+		return 1;
+	}
+	virtual int getNumOutputs() {
+		return 1;
+	}
+
+	static void classInit(int sample_rate) {
+	}
+
+	virtual void instanceConstants(int sample_rate) {
+		fSampleRate = sample_rate;
+		fConst0 = std::min<float>(192000.0f, std::max<float>(1.0f, static_cast<float>(fSampleRate)));
+		fConst1 = 10.0f / fConst0;
+		fConst2 = 3.14159274f / fConst0;
+		fConst3 = 0.000441799988f * fConst0;
+		fConst4 = 1.0f / (fConst3 + 1.0f);
+		fConst5 = 1.0f - fConst3;
+		fConst6 = 9.40000007e-08f * fConst0;
+	}
+
+	virtual void instanceResetUserInterface() {
+		fCheckbox0 = static_cast<FAUSTFLOAT>(0.0f);
+		fVslider0 = static_cast<FAUSTFLOAT>(400.0f);
+		fVslider1 = static_cast<FAUSTFLOAT>(0.5f);
+		fVslider2 = static_cast<FAUSTFLOAT>(-16.0f);
+	}
+
+	virtual void instanceClear() {
+		std::fill(fRec0, fRec0 + 2, 0.0f);
+		std::fill(fVec0, fVec0 + 2, 0.0f);
+		std::fill(fRec2, fRec2 + 2, 0.0f);
+		std::fill(fRec1, fRec1 + 2, 0.0f);
+		std::fill(fRec3, fRec3 + 2, 0.0f);
+		std::fill(fRec4, fRec4 + 2, 0.0f);
+	}
+
+	virtual void init(int sample_rate) {
+		classInit(sample_rate);
+		instanceInit(sample_rate);
+	}
+
+	virtual void instanceInit(int sample_rate) {
+		instanceConstants(sample_rate);
+		instanceResetUserInterface();
+		instanceClear();
+	}
+
+	virtual Ts9Native* clone() {
+		return new Ts9Native();
+	}
+
+	virtual int getSampleRate() {
+		return fSampleRate;
+	}
+
+	virtual void buildUserInterface(UI* ui_interface) {
+		ui_interface->openVerticalBox("TS9_OverdriveFaustGenerated");
+		ui_interface->openHorizontalBox("TubeScreamer");
+		ui_interface->declare(&fVslider1, "name", "Drive");
+		ui_interface->declare(&fVslider1, "style", "knob");
+		ui_interface->addVerticalSlider("drive", &fVslider1, FAUSTFLOAT(0.5f), FAUSTFLOAT(0.0f), FAUSTFLOAT(1.0f), FAUSTFLOAT(0.01f));
+		ui_interface->declare(&fVslider2, "name", "Level");
+		ui_interface->declare(&fVslider2, "style", "knob");
+		ui_interface->addVerticalSlider("level", &fVslider2, FAUSTFLOAT(-16.0f), FAUSTFLOAT(-20.0f), FAUSTFLOAT(4.0f), FAUSTFLOAT(0.1f));
+		ui_interface->declare(&fVslider0, "log", "");
+		ui_interface->declare(&fVslider0, "name", "Tone");
+		ui_interface->declare(&fVslider0, "style", "knob");
+		ui_interface->addVerticalSlider("tone", &fVslider0, FAUSTFLOAT(400.0f), FAUSTFLOAT(100.0f), FAUSTFLOAT(1000.0f), FAUSTFLOAT(1.03f));
+		ui_interface->closeBox();
+		ui_interface->addCheckButton("bypass", &fCheckbox0);
+		ui_interface->closeBox();
+	}
+
+	/** The WASM module's setParamValue: `index` is the JSON "index". */
+	void setParamValue(int index, float value) {
+		if (FAUSTFLOAT* zone = getZone(index))
+			*zone = static_cast<FAUSTFLOAT>(value);
+	}
+
+	float getParamValue(int index) {
+		const FAUSTFLOAT* zone = getZone(index);
+		return zone != nullptr ? static_cast<float>(*zone) : 0.0f;
+	}
+
+	virtual void compute(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
+		FAUSTFLOAT* input0 = inputs[0];
+		FAUSTFLOAT* output0 = outputs[0];
+		float fSlow0 = static_cast<float>(fCheckbox0);
+		float fSlow1 = 1.0f / std::tan(fConst2 * static_cast<float>(fVslider0));
+		float fSlow2 = 1.0f / (fSlow1 + 1.0f);
+		float fSlow3 = 1.0f - fSlow1;
+		float fSlow4 = fConst6 * (500000.0f * static_cast<float>(fVslider1) + 55700.0f);
+		float fSlow5 = fSlow4 + 1.0f;
+		float fSlow6 = 1.0f - fSlow4;
+		float fSlow7 = 0.00100000005f * std::pow(10.0f, 0.0500000007f * static_cast<float>(fVslider2));
+		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
+			float fTemp0 = static_cast<float>(input0[i0]);
+			float fTemp1 = fConst1 + fRec0[1];
+			float fTemp2 = fRec0[1] - fConst1;
+			fRec0[0] = flushDenormal((fTemp1 < fSlow0) ? fTemp1 : ((fTemp2 > fSlow0) ? fTemp2 : fSlow0));
+			float fTemp3 = 1.0f - fRec0[0];
+			float fTemp4 = fTemp0 * fTemp3;
+			fVec0[0] = fTemp4;
+			fRec2[0] = flushDenormal(0.0f - fConst4 * (fConst5 * fRec2[1] - (fSlow5 * fTemp4 + fSlow6 * fVec0[1])));
+			float fTemp5 = fRec2[0] - fTemp4;
+			float fTemp6 = std::fabs(fTemp5);
+			float fTemp7 = 101.970001f * (fTemp6 / (fTemp6 + 3.0f));
+			float fTemp8 = std::max<float>(0.0f, std::min<float>(99.0f, std::floor(fTemp7)));
+			float fTemp9 = ((0.0f < fTemp8) ? 0.0f : ((fTemp8 < 99.0f) ? fTemp7 - fTemp8 : 99.0f));
+			fRec1[0] = fTemp4 - std::fabs(ftbl0[static_cast<int>(fTemp8)] * (1.0f - fTemp9) + fTemp9 * ftbl0[static_cast<int>(fTemp8 + 1.0f)]) * static_cast<float>(((static_cast<float>((fTemp5 < 0.0f) ? 1 : -1) * fTemp6 < 0.0f) ? -1 : 1));
+			fRec3[0] = flushDenormal(0.0f - fSlow2 * (fSlow3 * fRec3[1] - (fRec1[0] + fRec1[1])));
+			fRec4[0] = flushDenormal(fSlow7 + 0.999000013f * fRec4[1]);
+			output0[i0] = static_cast<FAUSTFLOAT>(fTemp0 * fRec0[0] + fRec3[0] * fRec4[0] * fTemp3);
+			fRec0[1] = fRec0[0];
+			fVec0[1] = fVec0[0];
+			fRec2[1] = fRec2[0];
+			fRec1[1] = fRec1[0];
+			fRec3[1] = fRec3[0];
+			fRec4[1] = fRec4[0];
+		}
+	}
+
+ private:
+
+	FAUSTFLOAT* getZone(int index) {
+		switch (index) {
+			case bypassIndex: return &fCheckbox0;
+			case toneIndex: return &fVslider0;
+			case driveIndex: return &fVslider1;
+			case levelIndex: return &fVslider2;
+			default: return nullptr;
+		}
+	}
+
+};
+
+#endif
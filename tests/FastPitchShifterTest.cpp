@@ -0,0 +1,137 @@
+// Checks PitchShifterKernel::step, the per-sample kernel of the plugin's pitch
+// shifter bank and harmonizer, against the generated mydsp it replaces. It
+// runs inside FastPitchShifter, which gives it mydsp's interface: the same
+// input and sliders through both, over a grid of shifts, windows and
+// crossfades, and with the window jumping between blocks (shrinks below half
+// the old window included, which leave the phase beyond the new one).
+
+#include "pitchShifter.cpp"
+#include "FastPitchShifter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Both compute the same float expressions; FMA contraction may round
+    // them differently, so allow a few ulps rather than demanding bits
+    constexpr double tolerance = 1e-5;
+
+    struct Pair
+    {
+        // ~1 MB each, so on the heap
+        std::unique_ptr<mydsp> reference = std::make_unique<mydsp>();
+        std::unique_ptr<FastPitchShifter> fast = std::make_unique<FastPitchShifter>();
+
+        Pair()
+        {
+            reference->init(48000);
+            fast->init(48000);
+        }
+
+        void set(float shift, float window, float xfade)
+        {
+            reference->fHslider1 = fast->fHslider1 = shift;
+            reference->fHslider0 = fast->fHslider0 = window;
+            reference->fHslider2 = fast->fHslider2 = xfade;
+        }
+
+        // Runs both over `input` in blocks of `blockSize`; returns the
+        // largest difference
+        double run(std::vector<float>& input, int blockSize)
+        {
+            std::vector<float> expected(input.size()), actual(input.size());
+            double worst = 0.0;
+
+            for (size_t start = 0; start < input.size(); start += (size_t)blockSize)
+            {
+                const int numSamples = (int)std::min(input.size() - start, (size_t)blockSize);
+                float* in = input.data() + start;
+                float* out0 = expected.data() + start;
+                float* out1 = actual.data() + start;
+
+                reference->compute(numSamples, &in, &out0);
+                fast->compute(numSamples, &in, &out1);
+            }
+
+            for (size_t i = 0; i < input.size(); ++i)
+                worst = std::max(worst, (double)std::abs(expected[i] - actual[i]));
+
+            return worst;
+        }
+    };
+
+    std::vector<float> makeNoise(size_t numSamples, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+        std::vector<float> noise(numSamples);
+        for (auto& sample : noise)
+            sample = dist(rng);
+
+        return noise;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+    auto check = [&failures] (double difference, const char* what, float shift, float window, float xfade)
+    {
+        if (difference > tolerance)
+        {
+            std::printf("FAIL %s: shift %g, window %g, xfade %g differs by %g\n", what, shift, window, xfade, difference);
+            ++failures;
+        }
+    };
+
+    // Fixed sliders, in odd-sized blocks so the phase crosses block edges
+    // anywhere. 40000 is beyond the fast path's range, checking the fallback.
+    const float shifts[] = { -12.0f, -7.0f, -0.3f, 0.0f, 0.1f, 5.0f, 12.0f };
+    const float windows[] = { 50.0f, 333.0f, 1000.0f, 4096.0f, 10000.0f, 40000.0f };
+    const float xfades[] = { 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f };
+
+    unsigned seed = 1;
+    for (float shift : shifts)
+        for (float window : windows)
+            for (float xfade : xfades)
+            {
+                Pair pair;
+                pair.set(shift, window, xfade);
+
+                auto input = makeNoise(50000, seed++);
+                check(pair.run(input, 97), "grid", shift, window, xfade);
+            }
+
+    // The window moving between blocks, as ramps and parameter jumps do
+    const float windowSequences[][6] =
+    {
+        { 2537.0f, 50.0f, 4000.0f, 55.0f, 10000.0f, 60.0f },
+        { 9000.0f, 60.0f, 9000.0f, 51.0f, 40000.0f, 100.0f },
+        { 1000.0f, 999.0f, 400.0f, 70.0f, 69.5f, 9999.0f }
+    };
+
+    for (const auto& sequence : windowSequences)
+        for (float shift : { -12.0f, -3.5f, 7.0f, 12.0f })
+        {
+            Pair pair;
+
+            for (float window : sequence)
+            {
+                pair.set(shift, window, 100.0f);
+
+                auto input = makeNoise(6000, seed++);
+                check(pair.run(input, 128), "window change", shift, window, 100.0f);
+            }
+        }
+
+    if (failures == 0)
+        std::printf("PitchShifterKernel matches mydsp\n");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+// Times the TS9 in the wasm2c sandbox against its native translation
+// (fausts/Ts9Native.h), per block size. Both run on buffers inside the
+// module's linear memory, as Ts9Engine runs them, on the same noise and
+// parameters, so the difference is the sandbox: the linear memory
+// indirection and the imported powf/tanf.
+
+#include "FaustWasmRegistry.h"
+#include "WasmMemoryLayout.h"
+#include "WasmRuntime.h"
+#include "fausts/Ts9Native.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr int sampleRate = 48000;
+    constexpr int maxBlockSize = 4096;
+    constexpr int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 4096 };
+
+    constexpr double secondsPerRun = 60.0;  // of audio, per measurement
+    constexpr int numRuns = 5;              // the fastest one counts
+
+    // Every control at its default, with the drive up so the clipper works
+    template <typename SetParamValue>
+    void setParameters(const FaustWasmUiDescriptor& descriptor, SetParamValue&& setParamValue)
+    {
+        for (const auto& control : descriptor)
+            setParamValue(control.index, std::strcmp(control.label, "drive") == 0 ? 0.8f : control.init);
+    }
+
+    // Nanoseconds per sample of the fastest run
+    template <typename Compute>
+    double time(int blockSize, Compute&& compute)
+    {
+        const int numBlocks = (int)(secondsPerRun * sampleRate) / blockSize;
+        double best = 0.0;
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+                compute(blockSize);
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            const double perSample = elapsed.count() / ((double)numBlocks * blockSize);
+            best = run == 0 ? perSample : std::min(best, perSample);
+        }
+
+        return best;
+    }
+}
+
+int main()
+{
+    WasmRuntime::Reference runtime;
+
+    const auto* module = FaustWasmRegistry::findModule("ts9");
+    if (module == nullptr)
+    {
+        std::printf("The ts9 module is not registered\n");
+        return 1;
+    }
+
+    const auto& descriptor = module->descriptor;
+    constexpr u32 dsp = 0;
+
+    FaustWasmInstance instance(*module);
+    instance.init(dsp, sampleRate);
+    setParameters(descriptor, [&] (u32 index, float value) { instance.setParamValue(dsp, index, value); });
+
+    Ts9Native native;
+    native.init(sampleRate);
+    setParameters(descriptor, [&] (u32 index, float value) { native.setParamValue((int)index, value); });
+
+    // One set of slots for both: only the outputs differ, and they are
+    // compared, not kept
+    WasmLinearAllocator layout;
+    layout.reset(instance.getMemory(), descriptor.getReservedBytes());
+
+    WasmAudioSlots slots;
+    if (!slots.allocate(layout, maxBlockSize))
+    {
+        std::printf("The module's memory can't hold %d-sample buffers\n", maxBlockSize);
+        return 1;
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::generate(slots.input, slots.input + maxBlockSize, [&] { return noise(rng); });
+
+    auto computeWasm = [&] (int numSamples)
+    {
+        instance.compute(dsp, (u32)numSamples, slots.inputPointersAt(0), slots.outputPointersAt(0));
+    };
+
+    std::vector<float> nativeOutput((size_t)maxBlockSize);
+    auto computeNative = [&] (int numSamples)
+    {
+        float* in = slots.input;
+        float* out = nativeOutput.data();
+        native.compute(numSamples, &in, &out);
+    };
+
+    // Same state, same input: the outputs should agree to the bit on exact
+    // math (FUZZAVER_WASM_MATH=exact)
+    computeWasm(maxBlockSize);
+    computeNative(maxBlockSize);
+
+    float difference = 0.0f;
+    for (int i = 0; i < maxBlockSize; ++i)
+        difference = std::max(difference, std::abs(slots.output[i] - nativeOutput[(size_t)i]));
+
+    std::printf("TS9 at %d Hz, math \"%s\", largest wasm/native difference %g\n\n",
+                sampleRate, instance.getMathProvider().name, (double)difference);
+    std::printf("%8s %14s %14s %9s\n", "block", "wasm ns/smp", "native ns/smp", "speedup");
+
+    for (int blockSize : blockSizes)
+    {
+        const double wasm = time(blockSize, computeWasm);
+        const double nativeTime = time(blockSize, computeNative);
+        std::printf("%8d %14.2f %14.2f %8.2fx\n", blockSize, wasm, nativeTime, wasm / nativeTime);
+    }
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Runs separate TS9 instances on separate threads, as a host rendering several
+// plugin instances in parallel does, each thread holding its own runtime
+// Reference so the runtime is set up and torn down while others run. Checks:
+//  - isolation: every thread's output is bit-identical to the same instance
+//    (settings, input) run alone on one thread
+//  - the fault signal handlers in place before the first Reference are back
+//    once the last one is gone
+// It also reports how much faster the threads get through the instances than
+// one thread running them back to back; near 1x on several cores would mean
+// something in the runtime, the memory pool or the imports serialises them.
+// Shared CI machines make that figure too noisy to fail on, so it is printed
+// only.
+
+#include "FaustWasmRegistry.h"
+#include "WasmMemoryLayout.h"
+#include "WasmMemoryPool.h"
+#include "WasmRuntime.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+ #include <signal.h>
+#endif
+
+namespace
+{
+    constexpr u32 dsp = 0;
+    constexpr u32 sampleRate = 48000;
+    constexpr uint32_t blockSize = 128;
+    constexpr int numBlocks = (int)(20 * sampleRate / blockSize);    // 20 s of audio per instance
+    constexpr int numThreads = 4;
+    constexpr int numRounds = 3;    // the fastest sequential and parallel times are reported
+
+    // One plugin instance's worth of work: its own runtime reference, module
+    // instance and memory, with settings and input that differ per `index`
+    std::vector<float> runInstance(const FaustWasmModuleInfo& module, int index)
+    {
+        WasmRuntime::Reference runtime;
+        WasmRuntime::ensureThreadInitialised();
+
+        FaustWasmInstance instance(module);
+        instance.init(dsp, sampleRate);
+
+        for (const auto& control : module.descriptor)
+            if (std::strcmp(control.label, "drive") == 0)
+                instance.setParamValue(dsp, control.index, 0.2f + 0.15f * (float)index);
+
+        WasmLinearAllocator layout;
+        layout.reset(instance.getMemory(), module.descriptor.getReservedBytes());
+
+        WasmAudioSlots slots;
+        if (!slots.allocate(layout, blockSize))
+            return {};
+
+        std::mt19937 rng((unsigned)index + 1);
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        std::vector<float> output((size_t)numBlocks * blockSize);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            std::generate(slots.input, slots.input + blockSize, [&] { return noise(rng); });
+            instance.compute(dsp, blockSize, slots.inputPointersAt(0), slots.outputPointersAt(0));
+            std::copy(slots.output, slots.output + blockSize, output.begin() + (ptrdiff_t)block * blockSize);
+        }
+
+        return output;
+    }
+
+    template <typename Function>
+    double timeSeconds(Function&& function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+   #ifndef _WIN32
+    void sentinelHandler(int) {}
+
+    bool isSentinelInstalled(int signal)
+    {
+        struct sigaction current;
+        sigaction(signal, nullptr, &current);
+        return current.sa_handler == sentinelHandler;
+    }
+   #endif
+}
+
+int main()
+{
+   #ifndef _WIN32
+    // Stands in for a host's crash reporter
+    struct sigaction sentinel;
+    std::memset(&sentinel, 0, sizeof(sentinel));
+    sentinel.sa_handler = sentinelHandler;
+    sigemptyset(&sentinel.sa_mask);
+    sigaction(SIGSEGV, &sentinel, nullptr);
+    sigaction(SIGBUS, &sentinel, nullptr);
+   #endif
+
+    const auto* module = FaustWasmRegistry::findModule("ts9");
+    if (module == nullptr)
+    {
+        std::printf("The ts9 module is not registered\n");
+        return 1;
+    }
+
+    // As the plugin does; the threads borrow their memories from it at once
+    WasmMemoryPool::getInstance().install();
+
+    int failures = 0;
+
+    std::vector<std::vector<float>> expected((size_t)numThreads);
+    double sequential = 0.0, parallel = 0.0;
+
+    for (int round = 0; round < numRounds; ++round)
+    {
+        const double sequentialTime = timeSeconds([&]
+        {
+            for (int index = 0; index < numThreads; ++index)
+                expected[(size_t)index] = runInstance(*module, index);
+        });
+
+        std::vector<std::vector<float>> actual((size_t)numThreads);
+        const double parallelTime = timeSeconds([&]
+        {
+            std::vector<std::thread> threads;
+            for (int index = 0; index < numThreads; ++index)
+                threads.emplace_back([&, index] { actual[(size_t)index] = runInstance(*module, index); });
+
+            for (auto& thread : threads)
+                thread.join();
+        });
+
+        for (int index = 0; index < numThreads; ++index)
+        {
+            if (expected[(size_t)index].empty() || actual[(size_t)index] != expected[(size_t)index])
+            {
+                std::printf("FAIL round %d: instance %d computes differently on its own thread\n", round, index);
+                ++failures;
+            }
+        }
+
+        sequential = round == 0 ? sequentialTime : std::min(sequential, sequentialTime);
+        parallel = round == 0 ? parallelTime : std::min(parallel, parallelTime);
+    }
+
+    const unsigned numCores = std::thread::hardware_concurrency();
+    std::printf("%d instances: %.3f s one after another, %.3f s on %d threads over %u core(s), %.2fx\n",
+                numThreads, sequential, parallel, numThreads, numCores, sequential / parallel);
+
+   #ifndef _WIN32
+    if (WasmRuntime::getNumReferences() != 0 || !isSentinelInstalled(SIGSEGV) || !isSentinelInstalled(SIGBUS))
+    {
+        std::printf("FAIL: the fault handlers in place before the runtime weren't restored\n");
+        ++failures;
+    }
+   #endif
+
+    if (failures == 0)
+        std::printf("TS9 instances on separate threads are isolated\n");
+
+    return failures == 0 ? 0 : 1;
+}
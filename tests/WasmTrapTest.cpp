@@ -0,0 +1,123 @@
+// Checks WASM trap containment (src/WasmTrap.h) on the platform it runs on:
+// an out-of-bounds access inside the TS9 module, a guard page fault or an
+// explicit bounds check depending on the memory mode, must leave the module as
+// a WasmTrap the caller catches, every time, and leave the runtime working.
+// Throwing out of the fault signal handler through the generated C depends on
+// the compiler and the OS, so ctest runs this wherever containment is built.
+
+#include "FaustWasmRegistry.h"
+#include "WasmMemoryLayout.h"
+#include "WasmRuntime.h"
+#include "WasmTrap.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    constexpr u32 dsp = 0;
+    constexpr u32 sampleRate = 48000;
+    constexpr uint32_t numSamples = 256;
+    constexpr int numTraps = 4;    // later ones check the fault signals were unblocked
+
+    // Beyond any memory the module can have, 0x10 bytes short of 4 GiB
+    constexpr uint32_t badAddress = 0xfffffff0u;
+
+    // One module instance with its own I/O slots, initialised
+    struct Ts9
+    {
+        FaustWasmInstance instance;
+        WasmLinearAllocator layout;
+        WasmAudioSlots slots;
+
+        explicit Ts9(const FaustWasmModuleInfo& module)
+            : instance(module)
+        {
+            instance.init(dsp, sampleRate);
+            layout.reset(instance.getMemory(), module.descriptor.getReservedBytes());
+
+            if (slots.allocate(layout, numSamples))
+                for (uint32_t i = 0; i < numSamples; ++i)
+                    slots.input[i] = (float)((i * 37) % 101) / 101.0f - 0.5f;
+        }
+
+        std::vector<float> compute()
+        {
+            instance.compute(dsp, numSamples, slots.inputPointersAt(0), slots.outputPointersAt(0));
+            return { slots.output, slots.output + numSamples };
+        }
+
+        // Rewrites the input pointer the module reads its samples through
+        void setInputAddress(uint32_t address)
+        {
+            std::memcpy(instance.getMemory().data + slots.inputPointers, &address, sizeof(address));
+        }
+    };
+}
+
+int main()
+{
+    WasmRuntime::Reference runtime;
+
+    const auto* module = FaustWasmRegistry::findModule("ts9");
+    if (module == nullptr)
+    {
+        std::printf("The ts9 module is not registered\n");
+        return 1;
+    }
+
+    Ts9 reference(*module);
+    Ts9 faulty(*module);
+
+    if (reference.slots.capacity == 0 || faulty.slots.capacity == 0)
+    {
+        std::printf("The module's memory can't hold %u-sample buffers\n", numSamples);
+        return 1;
+    }
+
+    const auto expected = reference.compute();
+    int failures = 0;
+
+    for (int attempt = 0; attempt < numTraps; ++attempt)
+    {
+        faulty.setInputAddress(badAddress);
+        wasm_rt_trap_t caught = WASM_RT_TRAP_NONE;
+
+        {
+            const WasmTrapScope trapScope;
+
+            try
+            {
+                faulty.compute();
+            }
+            catch (const WasmTrap& trap)
+            {
+                caught = trap.code;
+            }
+        }
+
+        if (caught != WASM_RT_TRAP_OOB)
+        {
+            std::printf("FAIL trap %d: expected \"%s\", caught \"%s\"\n", attempt,
+                        wasm_rt_strerror(WASM_RT_TRAP_OOB), wasm_rt_strerror(caught));
+            ++failures;
+        }
+
+        // The trapped call may have left the state half updated, so start the
+        // instance again; it must then run exactly like one that never trapped
+        faulty.setInputAddress(faulty.slots.inputBuffer);
+        faulty.instance.init(dsp, sampleRate);
+
+        if (faulty.compute() != expected)
+        {
+            std::printf("FAIL trap %d: the instance computes differently after the trap\n", attempt);
+            ++failures;
+        }
+    }
+
+    if (failures == 0)
+        std::printf("Caught %d out-of-bounds traps as WasmTrap\n", numTraps);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -54,6 +54,18 @@ WASM_RT_THREAD_LOCAL uint32_t wasm_rt_call_stack_depth;
 WASM_RT_THREAD_LOCAL uint32_t wasm_rt_saved_call_stack_depth;
 #elif WASM_RT_STACK_EXHAUSTION_HANDLER
 static WASM_RT_THREAD_LOCAL void* g_alt_stack = NULL;
+/* Whether g_alt_stack came from malloc here rather than from
+ * wasm_rt_init_thread_with_alt_stack, i.e. whether to free it */
+static WASM_RT_THREAD_LOCAL bool g_alt_stack_owned = false;
+
+/* A trap handler that throws (WASM_RT_TRAP_HANDLER) unwinds out of the fault
+ * signal handler while still on the alternate stack, and the C++ unwinder
+ * needs far more of it than SIGSTKSZ. */
+#ifdef WASM_RT_TRAP_HANDLER
+#define WASM_RT_ALT_STACK_SIZE (SIGSTKSZ > 65536 ? (size_t)SIGSTKSZ : (size_t)65536)
+#else
+#define WASM_RT_ALT_STACK_SIZE ((size_t)SIGSTKSZ)
+#endif
 #endif
 
 WASM_RT_THREAD_LOCAL wasm_rt_jmp_buf g_wasm_rt_jmp_buf;
@@ -103,6 +115,11 @@ static void os_cleanup_signal_handler(void) {
 #else
 
 #if WASM_RT_INSTALL_SIGNAL_HANDLER
+/* The handlers in place before os_install_signal_handler, e.g. a host's crash
+ * reporter, put back by os_cleanup_signal_handler */
+static struct sigaction g_previous_sigsegv;
+static struct sigaction g_previous_sigbus;
+
 static void os_signal_handler(int sig, siginfo_t* si, void* unused) {
   if (si->si_code == SEGV_ACCERR) {
     wasm_rt_trap(WASM_RT_TRAP_OOB);
@@ -122,18 +139,18 @@ static void os_install_signal_handler(void) {
   sa.sa_sigaction = os_signal_handler;
 
   /* Install SIGSEGV and SIGBUS handlers, since macOS seems to use SIGBUS. */
-  if (sigaction(SIGSEGV, &sa, NULL) != 0 || sigaction(SIGBUS, &sa, NULL) != 0) {
+  if (sigaction(SIGSEGV, &sa, &g_previous_sigsegv) != 0 ||
+      sigaction(SIGBUS, &sa, &g_previous_sigbus) != 0) {
     perror("sigaction failed");
     abort();
   }
 }
 
 static void os_cleanup_signal_handler(void) {
-  /* Undo what was done in os_install_signal_handler */
-  struct sigaction sa;
-  memset(&sa, '\0', sizeof(sa));
-  sa.sa_handler = SIG_DFL;
-  if (sigaction(SIGSEGV, &sa, NULL) != 0 || sigaction(SIGBUS, &sa, NULL)) {
+  /* Undo what was done in os_install_signal_handler: restore the previous
+   * handlers rather than SIG_DFL, which would drop anyone else's */
+  if (sigaction(SIGSEGV, &g_previous_sigsegv, NULL) != 0 ||
+      sigaction(SIGBUS, &g_previous_sigbus, NULL) != 0) {
     perror("sigaction failed");
     abort();
   }
@@ -153,37 +170,46 @@ static bool os_has_altstack_installed() {
 }
 
 /* These routines set up an altstack to handle SIGSEGV from stack overflow. */
-static void os_allocate_and_install_altstack(void) {
-  /* verify altstack not already allocated */
-  assert(!g_alt_stack &&
-         "wasm-rt error: tried to re-allocate thread-local alternate stack");
-
+static void os_install_altstack(void* stack, bool owned) {
   /* We could check and warn if an altstack is already installed, but some
    * sanitizers install their own altstack, so this warning would fire
    * spuriously and break the test outputs. */
 
-  /* allocate altstack */
-  g_alt_stack = malloc(SIGSTKSZ);
-  if (g_alt_stack == NULL) {
-    perror("malloc failed");
-    abort();
-  }
+  g_alt_stack = stack;
+  g_alt_stack_owned = owned;
 
   /* install altstack */
   stack_t ss;
   ss.ss_sp = g_alt_stack;
   ss.ss_flags = 0;
-  ss.ss_size = SIGSTKSZ;
+  ss.ss_size = WASM_RT_ALT_STACK_SIZE;
   if (sigaltstack(&ss, NULL) != 0) {
     perror("sigaltstack failed");
     abort();
   }
 }
 
+static void os_allocate_and_install_altstack(void) {
+  /* already set up on this thread: initialising a thread is idempotent */
+  if (g_alt_stack) {
+    return;
+  }
+
+  /* allocate altstack */
+  void* stack = malloc(WASM_RT_ALT_STACK_SIZE);
+  if (stack == NULL) {
+    perror("malloc failed");
+    abort();
+  }
+
+  os_install_altstack(stack, true);
+}
+
 static void os_disable_and_deallocate_altstack(void) {
-  /* in debug build, verify altstack allocated */
-  assert(g_alt_stack &&
-         "wasm-rt error: thread-local alternate stack not allocated");
+  /* nothing set up on this thread, nothing to free */
+  if (!g_alt_stack) {
+    return;
+  }
 
   /* verify altstack was still in place */
   stack_t ss;
@@ -193,7 +219,7 @@ static void os_disable_and_deallocate_altstack(void) {
   }
 
   if ((!g_alt_stack) || (ss.ss_flags & SS_DISABLE) ||
-      (ss.ss_sp != g_alt_stack) || (ss.ss_size != SIGSTKSZ)) {
+      (ss.ss_sp != g_alt_stack) || (ss.ss_size != WASM_RT_ALT_STACK_SIZE)) {
     DEBUG_PRINTF(
         "wasm-rt warning: alternate stack was modified unexpectedly\n");
     return;
@@ -206,7 +232,11 @@ static void os_disable_and_deallocate_altstack(void) {
     abort();
   }
   assert(!os_has_altstack_installed());
-  free(g_alt_stack);
+  if (g_alt_stack_owned) {
+    free(g_alt_stack);
+  }
+  g_alt_stack = NULL;
+  g_alt_stack_owned = false;
 }
 #endif
 
@@ -251,6 +281,25 @@ void wasm_rt_init_thread(void) {
 #endif
 }
 
+void wasm_rt_init_thread_with_alt_stack(void* stack) {
+#if WASM_RT_STACK_EXHAUSTION_HANDLER
+  if (!g_alt_stack) {
+    os_install_altstack(stack, false);
+  }
+#else
+  (void)stack;
+  wasm_rt_init_thread();
+#endif
+}
+
+size_t wasm_rt_alt_stack_size(void) {
+#if WASM_RT_STACK_EXHAUSTION_HANDLER
+  return WASM_RT_ALT_STACK_SIZE;
+#else
+  return 0;
+#endif
+}
+
 void wasm_rt_free_thread(void) {
 #if WASM_RT_STACK_EXHAUSTION_HANDLER
   os_disable_and_deallocate_altstack();
@@ -29,6 +29,23 @@
 // https://github.com/WebAssembly/wabt/issues/2019#issuecomment-2308930257
 #define WASM_PAGE_SIZE 65536
 
+#if WASM_RT_USE_MMAP
+static wasm_rt_memory_source_t g_memory_source;
+#endif
+
+void wasm_rt_set_memory_source(const wasm_rt_memory_source_t* source) {
+#if WASM_RT_USE_MMAP
+  if (source) {
+    g_memory_source = *source;
+  } else {
+    wasm_rt_memory_source_t none = {0};
+    g_memory_source = none;
+  }
+#else
+  (void)source; /* unused */
+#endif
+}
+
 #ifdef WASM_RT_GROW_FAILED_HANDLER
 extern void WASM_RT_GROW_FAILED_HANDLER();
 #endif
@@ -79,12 +79,23 @@ extern "C" {
 
 #endif
 
+/**
+ * The runtime's per-thread state (jump buffer, call stack depth, altstack)
+ * must really be per thread when several threads run modules at once. GCC
+ * and Clang provide __thread in C and C++ alike, which also keeps C++
+ * translation units from seeing a plain global where the C code defines a
+ * thread-local (WASM_RT_C11_AVAILABLE is not defined above).
+ */
 #ifdef _MSC_VER
 #define WASM_RT_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define WASM_RT_THREAD_LOCAL __thread
 #elif defined(WASM_RT_C11_AVAILABLE)
 #define WASM_RT_THREAD_LOCAL _Thread_local
+#elif defined(__cplusplus)
+#define WASM_RT_THREAD_LOCAL thread_local
 #else
-#define WASM_RT_THREAD_LOCAL
+#error "No thread-local storage for the wasm2c runtime on this compiler"
 #endif
 
 /**
@@ -188,6 +199,13 @@ extern "C" {
     "Must choose at least one from WASM_RT_MEMCHECK_GUARD_PAGES and WASM_RT_MEMCHECK_BOUNDS_CHECK"
 #endif
 
+/**
+ * WASM_RT_MEMORY_MAX_PAGES, if defined, caps the maximum page count of every
+ * memory (never below its initial size). With BOUNDS_CHECK, where the mmap
+ * reservation follows the maximum, this bounds the address space each memory
+ * takes; growing past the cap fails like growing past a declared maximum.
+ */
+
 /**
  * Some configurations above require the Wasm runtime to install a signal
  * handler. However, this can be explicitly disallowed by the host using
@@ -485,6 +503,20 @@ void wasm_rt_free(void);
  */
 void wasm_rt_init_thread(void);
 
+/*
+ * Like wasm_rt_init_thread, but with an alternate signal stack of at least
+ * wasm_rt_alt_stack_size() bytes that the caller allocated, so setting up a
+ * thread doesn't call malloc. The caller keeps ownership of the stack: it
+ * must outlive the thread's state and is not freed by wasm_rt_free_thread.
+ * Without the stack exhaustion handler there is no alternate stack, and
+ * this is wasm_rt_init_thread.
+ */
+void wasm_rt_init_thread_with_alt_stack(void* stack);
+
+/* Bytes wasm_rt_init_thread_with_alt_stack needs, or 0 without the stack
+ * exhaustion handler. */
+size_t wasm_rt_alt_stack_size(void);
+
 /*
  * Free the individual thread's state.
  */
@@ -570,6 +602,32 @@ uint64_t wasm_rt_grow_memory(wasm_rt_memory_t*, uint64_t pages);
 /** Free a Memory object. */
 void wasm_rt_free_memory(wasm_rt_memory_t*);
 
+/**
+ * Optional host source for the address space behind linear memories, e.g. a
+ * pool that recycles them. Only used when WASM_RT_USE_MMAP is set.
+ *
+ * `reserve` returns `reserve_bytes` of address space whose first
+ * `commit_bytes` are readable, writable and zero, or NULL on failure. Growing
+ * a memory only changes the protection of pages inside its reservation.
+ * `release` takes a reservation back; its first `used_bytes` may be dirty.
+ *
+ * Set the source before the first memory is allocated and leave it in place,
+ * so that every memory is released to the source it came from.
+ */
+typedef struct {
+  void* (*reserve)(uint64_t reserve_bytes,
+                   uint64_t commit_bytes,
+                   void* user_data);
+  void (*release)(void* data,
+                  uint64_t reserve_bytes,
+                  uint64_t used_bytes,
+                  void* user_data);
+  void* user_data;
+} wasm_rt_memory_source_t;
+
+/** Installs `source` (copied), or restores plain mmap with NULL. */
+void wasm_rt_set_memory_source(const wasm_rt_memory_source_t* source);
+
 #ifdef WASM_RT_C11_AVAILABLE
 /** Shared memory version of wasm_rt_allocate_memory */
 void wasm_rt_allocate_memory_shared(wasm_rt_shared_memory_t*,